@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include <oryx/key_value_database.hpp>
+
+#include "../tests/test_utils.hpp"
+
+struct Telemetry {
+    std::string device;
+    int64_t timestamp;
+    double temperature;
+    double humidity;
+    bool online;
+};
+
+inline auto MakeTelemetry() -> Telemetry { return Telemetry{"sensor-0042", 1718000000123, 21.375, 48.5, true}; }
+
+// Same record with a numeric device id, stored in the packed fixed layout.
+struct TelemetrySample {
+    uint32_t device;
+    int64_t timestamp;
+    double temperature;
+    double humidity;
+    bool online;
+};
+
+template <>
+struct oryx::fixed_layout<TelemetrySample> : std::true_type {};
+
+inline auto MakeTelemetrySample() -> TelemetrySample { return TelemetrySample{42, 1718000000123, 21.375, 48.5, true}; }
+
+// Fixed width keys so sequential keys are also sorted keys.
+inline auto MakeKey(uint64_t index) -> std::string {
+    char key[24];
+    std::snprintf(key, sizeof(key), "key%016llu", static_cast<unsigned long long>(index));
+    return key;
+}
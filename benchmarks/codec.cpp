@@ -0,0 +1,110 @@
+#include <benchmark/benchmark.h>
+
+#include <oryx/key_value_database.hpp>
+
+#include "bench_utils.hpp"
+
+using namespace oryx;
+
+namespace {
+
+using FixedCodec = WithNumberFormat<JsonCodec, NumberFormat::kFixedLittleEndian>;
+
+template <typename T>
+auto SampleValue() -> T {
+    if constexpr (std::is_same_v<T, std::string>)
+        return std::string(64, 'x');
+    else if constexpr (std::is_same_v<T, bool>)
+        return true;
+    else if constexpr (std::is_same_v<T, Telemetry>)
+        return MakeTelemetry();
+    else if constexpr (std::is_same_v<T, TelemetrySample>)
+        return MakeTelemetrySample();
+    else if constexpr (std::is_floating_point_v<T>)
+        return static_cast<T>(-1234.5678);
+    else if constexpr (std::is_signed_v<T>)
+        return static_cast<T>(-1234567890);
+    else
+        return static_cast<T>(1234567890);
+}
+
+template <typename T, typename Codec>
+void BM_Write(benchmark::State& state) {
+    const T value = SampleValue<T>();
+    size_t bytes = 0;
+    for (auto _ : state) {
+        auto encoded = detail::Write<T, Codec>(value);
+        bytes += encoded.size();
+        benchmark::DoNotOptimize(encoded);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+
+template <typename T, typename Codec>
+void BM_Read(benchmark::State& state) {
+    const std::string encoded(detail::Write<T, Codec>(SampleValue<T>()));
+    for (auto _ : state) {
+        auto decoded = detail::Read<T, Codec>(encoded);
+        benchmark::DoNotOptimize(decoded);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * encoded.size()));
+}
+
+// Formatting used by detail::Write before it switched to shortest round trip std::to_chars, compare with
+// BM_Write<float, JsonCodec> and BM_Write<double, JsonCodec>.
+template <typename T>
+void BM_FloatToString(benchmark::State& state) {
+    const T value = SampleValue<T>();
+    for (auto _ : state) {
+        auto encoded = std::to_string(value);
+        benchmark::DoNotOptimize(encoded);
+    }
+}
+
+template <typename T, typename Codec>
+void BM_WriteTo(benchmark::State& state) {
+    const T value = SampleValue<T>();
+    std::string buffer;
+    for (auto _ : state) {
+        detail::WriteTo<T, Codec>(value, buffer);
+        benchmark::DoNotOptimize(buffer);
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * buffer.size()));
+}
+
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_FloatToString, float);
+BENCHMARK_TEMPLATE(BM_FloatToString, double);
+
+BENCHMARK_TEMPLATE(BM_Write, std::string, JsonCodec);
+BENCHMARK_TEMPLATE(BM_Write, bool, JsonCodec);
+BENCHMARK_TEMPLATE(BM_Write, int32_t, JsonCodec);
+BENCHMARK_TEMPLATE(BM_Write, int64_t, JsonCodec);
+BENCHMARK_TEMPLATE(BM_Write, uint64_t, JsonCodec);
+BENCHMARK_TEMPLATE(BM_Write, float, JsonCodec);
+BENCHMARK_TEMPLATE(BM_Write, double, JsonCodec);
+BENCHMARK_TEMPLATE(BM_Write, Telemetry, JsonCodec);
+BENCHMARK_TEMPLATE(BM_Write, TelemetrySample, JsonCodec);
+BENCHMARK_TEMPLATE(BM_Write, int64_t, FixedCodec);
+BENCHMARK_TEMPLATE(BM_Write, uint64_t, FixedCodec);
+BENCHMARK_TEMPLATE(BM_Write, double, FixedCodec);
+
+BENCHMARK_TEMPLATE(BM_WriteTo, int64_t, JsonCodec);
+BENCHMARK_TEMPLATE(BM_WriteTo, double, JsonCodec);
+BENCHMARK_TEMPLATE(BM_WriteTo, Telemetry, JsonCodec);
+BENCHMARK_TEMPLATE(BM_WriteTo, TelemetrySample, JsonCodec);
+BENCHMARK_TEMPLATE(BM_WriteTo, int64_t, FixedCodec);
+
+BENCHMARK_TEMPLATE(BM_Read, std::string, JsonCodec);
+BENCHMARK_TEMPLATE(BM_Read, bool, JsonCodec);
+BENCHMARK_TEMPLATE(BM_Read, int32_t, JsonCodec);
+BENCHMARK_TEMPLATE(BM_Read, int64_t, JsonCodec);
+BENCHMARK_TEMPLATE(BM_Read, uint64_t, JsonCodec);
+BENCHMARK_TEMPLATE(BM_Read, float, JsonCodec);
+BENCHMARK_TEMPLATE(BM_Read, double, JsonCodec);
+BENCHMARK_TEMPLATE(BM_Read, Telemetry, JsonCodec);
+BENCHMARK_TEMPLATE(BM_Read, TelemetrySample, JsonCodec);
+BENCHMARK_TEMPLATE(BM_Read, int64_t, FixedCodec);
+BENCHMARK_TEMPLATE(BM_Read, uint64_t, FixedCodec);
+BENCHMARK_TEMPLATE(BM_Read, double, FixedCodec);
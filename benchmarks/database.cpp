@@ -0,0 +1,169 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include <oryx/key_value_database.hpp>
+
+#include "bench_utils.hpp"
+
+using namespace oryx;
+
+namespace {
+
+constexpr uint64_t kPrefilledKeys = 10000;
+
+auto WriteOptions(bool sync) -> leveldb::WriteOptions {
+    leveldb::WriteOptions opts{};
+    opts.sync = sync;
+    return opts;
+}
+
+// Args: value size in bytes, sync.
+void BM_PutSequential(benchmark::State& state) {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    if (!db.Open(file.ToString()).ok()) {
+        state.SkipWithError("Failed to open db");
+        return;
+    }
+
+    const std::string value(static_cast<size_t>(state.range(0)), 'x');
+    const auto opts = WriteOptions(state.range(1) != 0);
+    uint64_t index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(db.Put(MakeKey(index++), value, opts));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * value.size()));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+void BM_PutRandom(benchmark::State& state) {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    if (!db.Open(file.ToString()).ok()) {
+        state.SkipWithError("Failed to open db");
+        return;
+    }
+
+    const std::string value(static_cast<size_t>(state.range(0)), 'x');
+    const auto opts = WriteOptions(state.range(1) != 0);
+    std::mt19937_64 rng(42);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(db.Put(MakeKey(rng()), value, opts));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * value.size()));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// Args: value size in bytes, random order.
+void BM_Get(benchmark::State& state) {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    if (!db.Open(file.ToString()).ok()) {
+        state.SkipWithError("Failed to open db");
+        return;
+    }
+
+    const std::string value(static_cast<size_t>(state.range(0)), 'x');
+    const uint64_t keys = std::min<uint64_t>(kPrefilledKeys, (64ULL << 20) / value.size());
+    for (uint64_t i = 0; i < keys; ++i) {
+        db.Put(MakeKey(i), value, WriteOptions(false));
+    }
+
+    const bool random = state.range(1) != 0;
+    std::mt19937_64 rng(42);
+    std::string result;
+    uint64_t index = 0;
+    for (auto _ : state) {
+        const uint64_t key = random ? rng() % keys : index++ % keys;
+        benchmark::DoNotOptimize(db.Get(MakeKey(key), result));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * value.size()));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+// Like BM_Get but visits the stored bytes instead of copying them into a string.
+void BM_GetView(benchmark::State& state) {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    if (!db.Open(file.ToString()).ok()) {
+        state.SkipWithError("Failed to open db");
+        return;
+    }
+
+    const std::string value(static_cast<size_t>(state.range(0)), 'x');
+    const uint64_t keys = std::min<uint64_t>(kPrefilledKeys, (64ULL << 20) / value.size());
+    for (uint64_t i = 0; i < keys; ++i) {
+        db.Put(MakeKey(i), value, WriteOptions(false));
+    }
+
+    const bool random = state.range(1) != 0;
+    std::mt19937_64 rng(42);
+    size_t visited = 0;
+    uint64_t index = 0;
+    for (auto _ : state) {
+        const uint64_t key = random ? rng() % keys : index++ % keys;
+        benchmark::DoNotOptimize(db.Get(MakeKey(key), [&](std::string_view bytes) { visited += bytes.size(); }));
+    }
+    benchmark::DoNotOptimize(visited);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * value.size()));
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+template <typename Db>
+void BM_PutStruct(benchmark::State& state) {
+    TempDbFile file{};
+    Db db{};
+    if (!db.Open(file.ToString()).ok()) {
+        state.SkipWithError("Failed to open db");
+        return;
+    }
+
+    const auto opts = WriteOptions(false);
+    const Telemetry value = MakeTelemetry();
+    uint64_t index = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(db.Put(MakeKey(index++), value, opts));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+template <typename Db>
+void BM_GetStruct(benchmark::State& state) {
+    TempDbFile file{};
+    Db db{};
+    if (!db.Open(file.ToString()).ok()) {
+        state.SkipWithError("Failed to open db");
+        return;
+    }
+
+    for (uint64_t i = 0; i < kPrefilledKeys; ++i) {
+        db.Put(MakeKey(i), MakeTelemetry(), WriteOptions(false));
+    }
+
+    std::mt19937_64 rng(42);
+    Telemetry result{};
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(db.Get(MakeKey(rng() % kPrefilledKeys), result));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()));
+}
+
+}  // namespace
+
+BENCHMARK(BM_PutSequential)
+    ->ArgNames({"value_size", "sync"})
+    ->ArgsProduct({{16, 128, 1024, 8192, 65536, 1 << 20}, {0}})
+    ->ArgsProduct({{16, 1024}, {1}});
+BENCHMARK(BM_PutRandom)
+    ->ArgNames({"value_size", "sync"})
+    ->ArgsProduct({{16, 128, 1024, 8192, 65536, 1 << 20}, {0}})
+    ->ArgsProduct({{16, 1024}, {1}});
+BENCHMARK(BM_Get)->ArgNames({"value_size", "random"})->ArgsProduct({{16, 128, 1024, 8192, 65536, 1 << 20}, {0, 1}});
+BENCHMARK(BM_GetView)
+    ->ArgNames({"value_size", "random"})
+    ->ArgsProduct({{16, 128, 1024, 8192, 65536, 1 << 20}, {0, 1}});
+BENCHMARK_TEMPLATE(BM_PutStruct, KeyValueDatabase);
+BENCHMARK_TEMPLATE(BM_PutStruct, MemoryKeyValueDatabase);
+BENCHMARK_TEMPLATE(BM_GetStruct, KeyValueDatabase);
+BENCHMARK_TEMPLATE(BM_GetStruct, MemoryKeyValueDatabase);
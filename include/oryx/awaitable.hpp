@@ -0,0 +1,58 @@
+#pragma once
+
+#include <coroutine>
+#include <functional>
+#include <optional>
+#include <utility>
+
+#include <oryx/executor.hpp>
+
+namespace oryx {
+
+// Result of the coroutine interface of BasicKeyValueDatabase, starts the operation when awaited and resumes the
+// awaiting coroutine through the executor it was created with, or inline where the operation finished without one.
+template <typename R>
+class [[nodiscard]] Awaitable {
+public:
+    using Done = std::function<void(R)>;
+    using Start = std::function<void(Done)>;
+    using Resume = std::function<void(std::function<void()>)>;
+
+    // Already finished, co_await does not suspend.
+    explicit Awaitable(R result)
+        : result_(std::move(result)) {}
+
+    Awaitable(Start start, Resume resume)
+        : start_(std::move(start)),
+          resume_(std::move(resume)) {}
+
+    template <Executor E>
+    static auto ResumeOn(E& executor) -> Resume {
+        return [&executor](std::function<void()> task) { executor.Submit(std::move(task)); };
+    }
+
+    auto await_ready() const noexcept -> bool { return result_.has_value(); }
+
+    // The operation may finish and resume the coroutine before start returns, so start and resume are moved out
+    // of this first.
+    void await_suspend(std::coroutine_handle<> handle) {
+        Start start = std::move(start_);
+        start([this, handle, resume = std::move(resume_)](R result) {
+            result_ = std::move(result);
+            if (resume) {
+                resume([handle] { handle.resume(); });
+            } else {
+                handle.resume();
+            }
+        });
+    }
+
+    auto await_resume() -> R { return std::move(*result_); }
+
+private:
+    std::optional<R> result_{};
+    Start start_{};
+    Resume resume_{};
+};
+
+}  // namespace oryx
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <concepts>
+#include <memory>
+#include <string>
+
+#include <leveldb/db.h>
+#include <leveldb/options.h>
+#include <leveldb/write_batch.h>
+
+namespace oryx {
+
+// Storage engine under BasicKeyValueDatabase. The members mirror leveldb::DB and are called on the concrete type,
+// so the typed API adds no virtual call of its own. Iterators stay leveldb::Iterator for ScanRange.
+template <typename B>
+concept StorageBackend = requires(B& backend,
+                                  std::unique_ptr<B>& opened,
+                                  const leveldb::Options& opts,
+                                  const std::string& name,
+                                  const leveldb::ReadOptions& read_opts,
+                                  const leveldb::WriteOptions& write_opts,
+                                  const leveldb::Slice& key,
+                                  leveldb::WriteBatch* batch,
+                                  std::string* value,
+                                  const leveldb::Snapshot* snapshot) {
+    { B::Open(opts, name, opened) } -> std::same_as<leveldb::Status>;
+    { backend.Put(write_opts, key, key) } -> std::same_as<leveldb::Status>;
+    { backend.Delete(write_opts, key) } -> std::same_as<leveldb::Status>;
+    { backend.Write(write_opts, batch) } -> std::same_as<leveldb::Status>;
+    { backend.Get(read_opts, key, value) } -> std::same_as<leveldb::Status>;
+    { backend.NewIterator(read_opts) } -> std::same_as<leveldb::Iterator*>;
+    { backend.GetSnapshot() } -> std::same_as<const leveldb::Snapshot*>;
+    backend.ReleaseSnapshot(snapshot);
+    { backend.GetProperty(key, value) } -> std::same_as<bool>;
+};
+
+// Whether B keeps its data under the name passed to Open. Backends that do not declare
+// static constexpr bool kInMemory = true;
+template <typename B>
+inline constexpr bool stores_on_disk_v = !requires { requires B::kInMemory; };
+
+// The leveldb database stored in the directory passed to Open.
+class LevelDbBackend {
+public:
+    explicit LevelDbBackend(std::unique_ptr<leveldb::DB> db)
+        : db_(std::move(db)) {}
+
+    static auto Open(const leveldb::Options& opts, const std::string& name, std::unique_ptr<LevelDbBackend>& opened)
+        -> leveldb::Status {
+        std::unique_ptr<leveldb::DB> db{};
+#ifdef __cpp_lib_out_ptr
+        const auto status = leveldb::DB::Open(opts, name, std::out_ptr(db));
+#else
+        leveldb::DB* raw;
+        const auto status = leveldb::DB::Open(opts, name, &raw);
+        if (status.ok()) {
+            db = std::unique_ptr<leveldb::DB>(raw);
+        }
+#endif
+        if (status.ok()) {
+            opened = std::make_unique<LevelDbBackend>(std::move(db));
+        }
+        return status;
+    }
+
+    auto Put(const leveldb::WriteOptions& opts, const leveldb::Slice& key, const leveldb::Slice& value)
+        -> leveldb::Status {
+        return db_->Put(opts, key, value);
+    }
+
+    auto Delete(const leveldb::WriteOptions& opts, const leveldb::Slice& key) -> leveldb::Status {
+        return db_->Delete(opts, key);
+    }
+
+    auto Write(const leveldb::WriteOptions& opts, leveldb::WriteBatch* batch) -> leveldb::Status {
+        return db_->Write(opts, batch);
+    }
+
+    auto Get(const leveldb::ReadOptions& opts, const leveldb::Slice& key, std::string* value) -> leveldb::Status {
+        return db_->Get(opts, key, value);
+    }
+
+    auto NewIterator(const leveldb::ReadOptions& opts) -> leveldb::Iterator* { return db_->NewIterator(opts); }
+    auto GetSnapshot() -> const leveldb::Snapshot* { return db_->GetSnapshot(); }
+    void ReleaseSnapshot(const leveldb::Snapshot* snapshot) { db_->ReleaseSnapshot(snapshot); }
+    auto GetProperty(const leveldb::Slice& property, std::string* value) -> bool {
+        return db_->GetProperty(property, value);
+    }
+
+    [[nodiscard]] auto handle() const -> leveldb::DB& { return *db_; }
+
+private:
+    std::unique_ptr<leveldb::DB> db_;
+};
+
+static_assert(StorageBackend<LevelDbBackend>);
+
+}  // namespace oryx
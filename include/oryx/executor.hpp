@@ -0,0 +1,328 @@
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <leveldb/options.h>
+#include <leveldb/status.h>
+#include <leveldb/write_batch.h>
+
+namespace oryx {
+
+// Anything that runs tasks, such as ThreadPool or the scheduler of an event loop.
+template <typename E>
+concept Executor = requires(E& executor, std::function<void()> task) { executor.Submit(std::move(task)); };
+
+// Runs tasks on the calling thread.
+struct InlineExecutor {
+    void Submit(std::function<void()> task) { task(); }
+};
+
+// Fixed number of workers fed from a bounded queue.
+class ThreadPool {
+public:
+    explicit ThreadPool(size_t threads, size_t max_queued = 4096)
+        : max_queued_(max_queued == 0 ? 1 : max_queued) {
+        const size_t count = threads == 0 ? 1 : threads;
+        workers_.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            workers_.emplace_back([this] { Run(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    auto operator=(const ThreadPool&) -> ThreadPool& = delete;
+
+    ~ThreadPool() { Shutdown(); }
+
+    // Blocks while max_queued tasks are waiting for a worker. Runs task on the calling thread after Shutdown.
+    void Submit(std::function<void()> task) {
+        {
+            std::unique_lock lock(mutex_);
+            not_full_.wait(lock, [this] { return stop_ || tasks_.size() < max_queued_; });
+            if (!stop_) {
+                tasks_.push_back(std::move(task));
+                lock.unlock();
+                not_empty_.notify_one();
+                return;
+            }
+        }
+        task();
+    }
+
+    // Queues task unless max_queued tasks are already waiting or the pool is shut down, never blocks.
+    auto TrySubmit(std::function<void()>& task) -> bool {
+        {
+            std::lock_guard lock(mutex_);
+            if (stop_ || tasks_.size() >= max_queued_) {
+                return false;
+            }
+            tasks_.push_back(std::move(task));
+        }
+        not_empty_.notify_one();
+        return true;
+    }
+
+    template <typename Fn>
+    auto Async(Fn fn) -> std::future<std::invoke_result_t<Fn&>> {
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<Fn&>()>>(std::move(fn));
+        auto result = task->get_future();
+        Submit([task] { (*task)(); });
+        return result;
+    }
+
+    // Runs the tasks submitted so far and joins the workers.
+    void Shutdown() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        not_empty_.notify_all();
+        not_full_.notify_all();
+        for (auto& worker : workers_) {
+            if (worker.joinable()) {
+                worker.join();
+            }
+        }
+    }
+
+    [[nodiscard]] auto size() const -> size_t { return workers_.size(); }
+
+    // Whether the calling thread is a worker of this pool, which must not block on tasks queued behind it.
+    [[nodiscard]] auto OnWorker() const -> bool { return Current() == this; }
+
+private:
+    static auto Current() -> const ThreadPool*& {
+        thread_local const ThreadPool* pool = nullptr;
+        return pool;
+    }
+
+    void Run() {
+        Current() = this;
+        std::unique_lock lock(mutex_);
+        while (true) {
+            not_empty_.wait(lock, [this] { return stop_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                return;
+            }
+
+            auto task = std::move(tasks_.front());
+            tasks_.pop_front();
+            lock.unlock();
+            not_full_.notify_one();
+            task();
+            lock.lock();
+        }
+    }
+
+    size_t max_queued_;
+    std::mutex mutex_{};
+    std::condition_variable not_empty_{};
+    std::condition_variable not_full_{};
+    std::deque<std::function<void()>> tasks_{};
+    bool stop_{false};
+    std::vector<std::thread> workers_{};
+};
+
+struct AsyncOptions {
+    // Workers running async reads and the coalesced writes.
+    size_t threads = 4;
+    // Submitting blocks while this many async reads are waiting for a worker.
+    size_t max_queued = 4096;
+    // Async writers block while this many bytes are waiting to be written. A write is always accepted into an
+    // empty batch, so any value works, even below the size of a single write.
+    size_t max_batch_bytes = 4 * 1024 * 1024;
+};
+
+namespace detail {
+
+// Appends async writes to a shared batch that one worker at a time writes, so writes arriving while a batch
+// is being written and synced are written together with the next sync.
+class WriteCoalescer {
+public:
+    using WriteFn = std::function<leveldb::Status(leveldb::WriteBatch&, bool sync)>;
+    using Done = std::function<void(const leveldb::Status&)>;
+
+    WriteCoalescer(ThreadPool& pool, size_t max_batch_bytes, WriteFn write)
+        : pool_(pool),
+          max_batch_bytes_(max_batch_bytes),
+          write_(std::move(write)) {}
+
+    WriteCoalescer(const WriteCoalescer&) = delete;
+    auto operator=(const WriteCoalescer&) -> WriteCoalescer& = delete;
+
+    // done runs on a worker once the batch holding the write was written.
+    void Put(std::string_view key, std::string_view value, bool sync, Done done) {
+        Enqueue(sync, std::move(done), [&](leveldb::WriteBatch& batch) {
+            batch.Put(leveldb::Slice(key.data(), key.size()), leveldb::Slice(value.data(), value.size()));
+        });
+    }
+
+    void Delete(std::string_view key, bool sync, Done done) {
+        Enqueue(sync, std::move(done),
+                [&](leveldb::WriteBatch& batch) { batch.Delete(leveldb::Slice(key.data(), key.size())); });
+    }
+
+    auto Put(std::string_view key, std::string_view value, bool sync) -> std::future<leveldb::Status> {
+        auto [done, result] = Promise();
+        Put(key, value, sync, std::move(done));
+        return std::move(result);
+    }
+
+    auto Delete(std::string_view key, bool sync) -> std::future<leveldb::Status> {
+        auto [done, result] = Promise();
+        Delete(key, sync, std::move(done));
+        return std::move(result);
+    }
+
+private:
+    static auto Promise() -> std::pair<Done, std::future<leveldb::Status>> {
+        auto promise = std::make_shared<std::promise<leveldb::Status>>();
+        auto result = promise->get_future();
+        return {[promise](const leveldb::Status& status) { promise->set_value(status); }, std::move(result)};
+    }
+
+    template <typename Fn>
+    void Enqueue(bool sync, Done done, Fn&& append) {
+        bool schedule = false;
+        {
+            std::unique_lock lock(mutex_);
+            // An empty batch has a header of its own, checking only the size would block forever for a limit
+            // below it. Writes from the workers, such as from a waiter, are always accepted, the drain that makes
+            // room may be queued behind them.
+            drained_.wait(lock, [this] {
+                return waiters_.empty() || pending_->ApproximateSize() < max_batch_bytes_ || pool_.OnWorker();
+            });
+            append(*pending_);
+            waiters_.push_back(std::move(done));
+            sync_ = sync_ || sync;
+            schedule = !scheduled_;
+            scheduled_ = true;
+        }
+        if (schedule) {
+            pool_.Submit([this] { Drain(); });
+        }
+    }
+
+    // The next batch is handed to another worker before the waiters of a batch run, so a waiter that writes
+    // again or blocks does not hold up the writers after it. With the queue full this worker writes it after the
+    // waiters.
+    void Drain() {
+        std::unique_lock lock(mutex_);
+        while (true) {
+            auto batch = std::exchange(pending_, std::make_unique<leveldb::WriteBatch>());
+            std::vector<Done> waiters = std::exchange(waiters_, {});
+            const bool sync = std::exchange(sync_, false);
+            lock.unlock();
+            drained_.notify_all();
+
+            const leveldb::Status status = write_(*batch, sync);
+            lock.lock();
+            scheduled_ = !waiters_.empty();
+            const bool more = scheduled_;
+            lock.unlock();
+
+            std::function<void()> next = [this] { Drain(); };
+            const bool handed_off = !more || pool_.TrySubmit(next);
+            for (auto& waiter : waiters) {
+                waiter(status);
+            }
+            if (handed_off) {
+                return;
+            }
+            lock.lock();
+        }
+    }
+
+    ThreadPool& pool_;
+    size_t max_batch_bytes_;
+    WriteFn write_;
+    std::mutex mutex_{};
+    std::condition_variable drained_{};
+    std::unique_ptr<leveldb::WriteBatch> pending_{std::make_unique<leveldb::WriteBatch>()};
+    std::vector<Done> waiters_{};
+    bool sync_{false};
+    bool scheduled_{false};
+};
+
+struct PendingRead {
+    std::string key;
+    leveldb::ReadOptions opts;
+    // Receives the stored bytes, which are only valid during the call.
+    std::function<void(const leveldb::Status&, std::string_view)> done;
+};
+
+// Collects async reads until a worker picks them up, so all reads submitted in the meantime are handed to one
+// call of read, which can sort them and share an iterator.
+class ReadCoalescer {
+public:
+    using ReadFn = std::function<void(std::vector<PendingRead>&)>;
+
+    ReadCoalescer(ThreadPool& pool, ReadFn read)
+        : pool_(pool),
+          read_(std::move(read)) {}
+
+    ReadCoalescer(const ReadCoalescer&) = delete;
+    auto operator=(const ReadCoalescer&) -> ReadCoalescer& = delete;
+
+    void Get(PendingRead read) {
+        bool schedule = false;
+        {
+            std::lock_guard lock(mutex_);
+            pending_.push_back(std::move(read));
+            schedule = !scheduled_;
+            scheduled_ = true;
+        }
+        if (schedule) {
+            pool_.Submit([this] { Drain(); });
+        }
+    }
+
+private:
+    void Drain() {
+        std::unique_lock lock(mutex_);
+        while (!pending_.empty()) {
+            std::vector<PendingRead> reads = std::exchange(pending_, {});
+            lock.unlock();
+            read_(reads);
+            lock.lock();
+        }
+        scheduled_ = false;
+    }
+
+    ThreadPool& pool_;
+    ReadFn read_;
+    std::mutex mutex_{};
+    std::vector<PendingRead> pending_{};
+    bool scheduled_{false};
+};
+
+// Workers and coalescers of a database, the workers finish all queued operations before the coalescer
+// goes away.
+struct AsyncWorkers {
+    AsyncWorkers(const AsyncOptions& opts, WriteCoalescer::WriteFn write, ReadCoalescer::ReadFn read)
+        : pool(opts.threads, opts.max_queued),
+          writes(pool, opts.max_batch_bytes, std::move(write)),
+          reads(pool, std::move(read)) {}
+
+    ~AsyncWorkers() { pool.Shutdown(); }
+
+    ThreadPool pool;
+    WriteCoalescer writes;
+    ReadCoalescer reads;
+};
+
+}  // namespace detail
+}  // namespace oryx
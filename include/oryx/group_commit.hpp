@@ -0,0 +1,130 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#include <leveldb/db.h>
+#include <leveldb/write_batch.h>
+
+namespace oryx {
+
+enum class Durability : uint8_t {
+    kSync,         // every write waits for an fsync of the log
+    kGroupCommit,  // writes are acknowledged once they are in the log, a background thread syncs them in groups
+};
+
+struct GroupCommitOptions {
+    // Upper bound for how long an acknowledged write stays unsynced.
+    std::chrono::milliseconds interval{10};
+    // Sync early once this many bytes have been written since the last sync.
+    size_t max_pending_bytes = 1024 * 1024;
+};
+
+namespace detail {
+
+// Periodically syncs the log of a database whose writes are issued with sync = false.
+class GroupCommitter {
+public:
+    template <typename Db>
+    GroupCommitter(Db& db, const GroupCommitOptions& opts)
+        : sync_log_([&db] { return SyncLog(db); }),
+          opts_(opts),
+          next_(next_promise_.get_future().share()),
+          thread_([this] { Run(); }) {}
+
+    GroupCommitter(const GroupCommitter&) = delete;
+    auto operator=(const GroupCommitter&) -> GroupCommitter& = delete;
+
+    ~GroupCommitter() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_one();
+        thread_.join();
+    }
+
+    // Must be called after every write that went to the log unsynced.
+    void Record(size_t bytes) {
+        bool wake = false;
+        {
+            std::lock_guard lock(mutex_);
+            ++written_;
+            pending_bytes_ += bytes;
+            wake = pending_bytes_ >= opts_.max_pending_bytes;
+        }
+        if (wake) {
+            cv_.notify_one();
+        }
+    }
+
+    // Becomes ready once every write recorded so far has been synced.
+    auto Durable() -> std::shared_future<leveldb::Status> {
+        std::lock_guard lock(mutex_);
+        if (synced_ == written_) {
+            std::promise<leveldb::Status> ready;
+            ready.set_value(last_status_);
+            return ready.get_future().share();
+        }
+        return syncing_ == written_ ? inflight_ : next_;
+    }
+
+private:
+    void Run() {
+        std::unique_lock lock(mutex_);
+        while (true) {
+            cv_.wait_for(lock, opts_.interval, [this] { return stop_ || pending_bytes_ >= opts_.max_pending_bytes; });
+            if (written_ == syncing_) {
+                if (stop_) {
+                    return;
+                }
+                continue;
+            }
+
+            std::promise<leveldb::Status> promise = std::exchange(next_promise_, {});
+            inflight_ = std::exchange(next_, next_promise_.get_future().share());
+            syncing_ = written_;
+            pending_bytes_ = 0;
+
+            lock.unlock();
+            const leveldb::Status status = sync_log_();
+            lock.lock();
+
+            synced_ = syncing_;
+            last_status_ = status;
+            promise.set_value(status);
+        }
+    }
+
+    // leveldb syncs the log for every write with sync = true, an empty batch does nothing but the fsync.
+    template <typename Db>
+    static auto SyncLog(Db& db) -> leveldb::Status {
+        leveldb::WriteOptions opts{};
+        opts.sync = true;
+        leveldb::WriteBatch empty{};
+        return db.Write(opts, &empty);
+    }
+
+    std::function<leveldb::Status()> sync_log_;
+    GroupCommitOptions opts_;
+    std::mutex mutex_{};
+    std::condition_variable cv_{};
+    bool stop_{false};
+    size_t pending_bytes_{0};
+    uint64_t written_{0};
+    uint64_t syncing_{0};
+    uint64_t synced_{0};
+    leveldb::Status last_status_{};
+    std::promise<leveldb::Status> next_promise_{};
+    std::shared_future<leveldb::Status> next_;
+    std::shared_future<leveldb::Status> inflight_{};
+    std::thread thread_;
+};
+
+}  // namespace detail
+}  // namespace oryx
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#include <oryx/key_value_database.hpp>
+
+namespace oryx {
+
+// Encodes one part of a composite key so that bytewise order of the encoding matches the order of the values and
+// every encoding is self delimiting. Specialize to support your own types:
+// template <> struct oryx::key_part<MyId> {
+//     static void Append(std::string& out, const MyId& val);
+//     static auto Consume(std::string_view& in, MyId& val) -> bool;
+// };
+template <typename T>
+struct key_part {
+    static void Append(std::string& out, const T& val) {
+        if constexpr (std::is_same_v<T, bool>) {
+            out.push_back(val ? '\x01' : '\x00');
+        } else if constexpr (std::is_enum_v<T>) {
+            key_part<std::underlying_type_t<T>>::Append(out, static_cast<std::underlying_type_t<T>>(val));
+        } else if constexpr (detail::is_fixed_number_v<T>) {
+            auto bits = detail::ToOrderedBits(val);
+            if constexpr (std::endian::native == std::endian::little) bits = detail::ByteSwap(bits);
+            out.append(reinterpret_cast<const char*>(&bits), sizeof(bits));
+        } else {
+            static_assert(sizeof(T) == 0, "Unsupported key part, specialize oryx::key_part");
+        }
+    }
+
+    static auto Consume(std::string_view& in, T& val) -> bool {
+        if constexpr (std::is_same_v<T, bool>) {
+            if (in.empty() || static_cast<uint8_t>(in.front()) > 1) {
+                return false;
+            }
+            val = in.front() == '\x01';
+            in.remove_prefix(1);
+            return true;
+        } else if constexpr (std::is_enum_v<T>) {
+            std::underlying_type_t<T> underlying{};
+            if (!key_part<std::underlying_type_t<T>>::Consume(in, underlying)) {
+                return false;
+            }
+            val = static_cast<T>(underlying);
+            return true;
+        } else {
+            detail::fixed_bits_t<T> bits;
+            if (in.size() < sizeof(bits)) {
+                return false;
+            }
+            std::memcpy(&bits, in.data(), sizeof(bits));
+            if constexpr (std::endian::native == std::endian::little) bits = detail::ByteSwap(bits);
+            val = detail::FromOrderedBits<T>(bits);
+            in.remove_prefix(sizeof(bits));
+            return true;
+        }
+    }
+};
+
+// Strings escape 0x00 as 0x00 0xFF and end with 0x00 0x01, so a string sorts before all of its extensions.
+template <>
+struct key_part<std::string_view> {
+    static void Append(std::string& out, std::string_view val) {
+        for (const char c : val) {
+            out.push_back(c);
+            if (c == '\x00') {
+                out.push_back('\xFF');
+            }
+        }
+        out.append("\x00\x01", 2);
+    }
+};
+
+template <>
+struct key_part<std::string> {
+    static void Append(std::string& out, const std::string& val) { key_part<std::string_view>::Append(out, val); }
+
+    static auto Consume(std::string_view& in, std::string& val) -> bool {
+        val.clear();
+        for (size_t i = 0; i + 1 < in.size(); ++i) {
+            if (in[i] != '\x00') {
+                val.push_back(in[i]);
+            } else if (in[i + 1] == '\xFF') {
+                val.push_back('\x00');
+                ++i;
+            } else if (in[i + 1] == '\x01') {
+                in.remove_prefix(i + 2);
+                return true;
+            } else {
+                return false;
+            }
+        }
+        return false;
+    }
+};
+
+template <typename Rep, typename Period>
+struct key_part<std::chrono::duration<Rep, Period>> {
+    static void Append(std::string& out, const std::chrono::duration<Rep, Period>& val) {
+        key_part<Rep>::Append(out, val.count());
+    }
+
+    static auto Consume(std::string_view& in, std::chrono::duration<Rep, Period>& val) -> bool {
+        Rep count{};
+        if (!key_part<Rep>::Consume(in, count)) {
+            return false;
+        }
+        val = std::chrono::duration<Rep, Period>(count);
+        return true;
+    }
+};
+
+template <typename Clock, typename Duration>
+struct key_part<std::chrono::time_point<Clock, Duration>> {
+    static void Append(std::string& out, const std::chrono::time_point<Clock, Duration>& val) {
+        key_part<Duration>::Append(out, val.time_since_epoch());
+    }
+
+    static auto Consume(std::string_view& in, std::chrono::time_point<Clock, Duration>& val) -> bool {
+        Duration since_epoch{};
+        if (!key_part<Duration>::Consume(in, since_epoch)) {
+            return false;
+        }
+        val = std::chrono::time_point<Clock, Duration>(since_epoch);
+        return true;
+    }
+};
+
+// Type a key part decodes to, views decode to owning strings.
+template <typename T>
+using key_part_decoded_t = std::conditional_t<std::is_same_v<T, std::string_view>, std::string, T>;
+
+// Composite key whose encoding sorts like the tuple (Ts...), so numeric ranges become contiguous scans and a key
+// made of the first parts is a prefix of all keys that start with them. Converts to leveldb::Slice so it can be
+// passed to Get, Put, Delete, Scan and ScanPrefix directly:
+// db.Put(oryx::Key("user", uint64_t{42}), user);
+// db.Scan<User>(oryx::Key("user", uint64_t{10}), oryx::Key("user", uint64_t{20}));
+template <typename... Ts>
+class Key {
+public:
+    using decoded_type = std::tuple<key_part_decoded_t<Ts>...>;
+
+    explicit Key(const Ts&... parts) { (key_part<Ts>::Append(bytes_, parts), ...); }
+
+    // Returns nullopt if bytes is not exactly an encoded (Ts...) tuple.
+    static auto Decode(std::string_view bytes) -> std::optional<decoded_type> {
+        decoded_type parts{};
+        const bool ok = std::apply(
+            [&](auto&... part) {
+                return (key_part<std::remove_cvref_t<decltype(part)>>::Consume(bytes, part) && ...);
+            },
+            parts);
+        if (!ok || !bytes.empty()) {
+            return std::nullopt;
+        }
+        return parts;
+    }
+
+    [[nodiscard]] auto bytes() const -> const std::string& { return bytes_; }
+    [[nodiscard]] auto slice() const -> leveldb::Slice { return bytes_; }
+    operator leveldb::Slice() const { return bytes_; }
+
+    friend auto operator<=>(const Key&, const Key&) = default;
+
+private:
+    std::string bytes_{};
+};
+
+// String literals and char pointers become views, so building a key copies them only once.
+template <typename T>
+using key_part_t =
+    std::conditional_t<std::is_convertible_v<const T&, std::string_view> && !std::is_same_v<T, std::string>,
+                       std::string_view,
+                       T>;
+
+template <typename... Ts>
+Key(const Ts&...) -> Key<key_part_t<Ts>...>;
+
+}  // namespace oryx
@@ -1,17 +1,302 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <optional>
 #include <type_traits>
 #include <charconv>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
 #include <memory>
+#include <vector>
+#include <concepts>
+#include <functional>
+#include <algorithm>
+#include <future>
+#include <span>
+#include <iterator>
+#include <map>
+#include <ranges>
+#include <tuple>
+#include <typeindex>
+#include <unordered_map>
 
 #include <leveldb/db.h>
+#include <leveldb/comparator.h>
+#include <leveldb/filter_policy.h>
+#include <leveldb/write_batch.h>
 #include <rfl/Result.hpp>
 #include <rfl/json/write.hpp>
 #include <rfl/json/read.hpp>
+#include <rfl/json/Parser.hpp>
+#include <rfl/json/Writer.hpp>
+#include <rfl/NamedTuple.hpp>
+#include <rfl/named_tuple_t.hpp>
+#include <rfl/to_view.hpp>
+
+#include <oryx/awaitable.hpp>
+#include <oryx/backend.hpp>
+#include <oryx/executor.hpp>
+#include <oryx/group_commit.hpp>
+#include <oryx/memory_backend.hpp>
+#include <oryx/metrics.hpp>
+#include <oryx/negative_cache.hpp>
+#include <oryx/object_cache.hpp>
+#include <oryx/resource_manager.hpp>
+#include <oryx/stats.hpp>
+#include <oryx/value_compressor.hpp>
+#include <oryx/write_behind.hpp>
+
+#ifdef ORYX_KVDB_MSGPACK
+    #include <rfl/msgpack.hpp>
+#endif
+
+#ifdef ORYX_KVDB_CBOR
+    #include <rfl/cbor.hpp>
+#endif
+
+#ifdef ORYX_KVDB_ZSTD
+    #include <oryx/zstd_dictionary.hpp>
+#endif
 
 namespace oryx {
+
+namespace detail {
+
+// Bump allocator for yyjson over a per thread buffer, so writing json does not allocate once the buffer fits the
+// largest document of the thread. Running out is recorded instead of falling back to the heap, the document is
+// then written again into a larger buffer.
+class JsonArena {
+public:
+    static auto ForThread() -> JsonArena& {
+        thread_local JsonArena arena;
+        return arena;
+    }
+
+    auto allocator() -> yyjson_alc { return yyjson_alc{&Malloc, &Realloc, &Free, this}; }
+
+    // Forgets all allocations.
+    void Reset() {
+        used_ = 0;
+        last_ = 0;
+        exhausted_ = false;
+    }
+
+    [[nodiscard]] auto exhausted() const -> bool { return exhausted_; }
+
+    // Doubles the buffer, false once it reached kMaxBytes. Documents larger than that are written on the heap.
+    auto Grow() -> bool {
+        if (buffer_.size() >= kMaxBytes) {
+            return false;
+        }
+        buffer_.resize(buffer_.size() * 2);
+        return true;
+    }
+
+    // Large documents should not pin their memory on every thread that ever wrote one.
+    void Trim() {
+        if (buffer_.size() > kMaxRetainedBytes) {
+            std::vector<unsigned char>(kInitialBytes).swap(buffer_);
+        }
+    }
+
+private:
+    static constexpr size_t kInitialBytes = 16 * 1024;
+    static constexpr size_t kMaxRetainedBytes = 256 * 1024;
+    static constexpr size_t kMaxBytes = 64 * 1024 * 1024;
+    static constexpr size_t kAlignment = alignof(std::max_align_t);
+
+    auto Allocate(size_t size) -> void* {
+        const size_t begin = (used_ + kAlignment - 1) / kAlignment * kAlignment;
+        if (begin + size > buffer_.size()) {
+            exhausted_ = true;
+            return nullptr;
+        }
+        last_ = begin;
+        used_ = begin + size;
+        return buffer_.data() + begin;
+    }
+
+    static auto Malloc(void* ctx, size_t size) -> void* { return static_cast<JsonArena*>(ctx)->Allocate(size); }
+
+    // The last allocation grows in place, anything else is copied.
+    static auto Realloc(void* ctx, void* ptr, size_t old_size, size_t size) -> void* {
+        auto& arena = *static_cast<JsonArena*>(ctx);
+        if (ptr == arena.buffer_.data() + arena.last_ && arena.last_ + size <= arena.buffer_.size()) {
+            arena.used_ = arena.last_ + size;
+            return ptr;
+        }
+        void* moved = arena.Allocate(size);
+        if (moved != nullptr && ptr != nullptr) {
+            std::memcpy(moved, ptr, std::min(old_size, size));
+        }
+        return moved;
+    }
+
+    static void Free(void*, void*) {}
+
+    std::vector<unsigned char> buffer_ = std::vector<unsigned char>(kInitialBytes);
+    size_t used_{0};
+    size_t last_{0};
+    bool exhausted_{false};
+};
+
+// Writing into the arena uses reflect-cpp internals that are not part of its API: the Writer constructor taking
+// a document, its doc_ member and Parser::write, as of the pinned v0.21.0. Other versions fall back to
+// rfl::json::write.
+template <typename T>
+concept ArenaJsonWritable = requires(yyjson_mut_doc* doc, rfl::json::Writer& writer, const T& obj) {
+    rfl::json::Writer(doc);
+    { writer.doc_ } -> std::convertible_to<yyjson_mut_doc*>;
+    rfl::json::Parser<T, rfl::Processors<>>::write(writer, obj,
+                                                   typename rfl::parsing::Parent<rfl::json::Writer>::Root{});
+};
+
+}  // namespace detail
+
+// Default codec for everything that is not natively supported, uses reflect-cpp json.
+struct JsonCodec {
+    template <typename T>
+    static auto Read(std::string_view val) -> std::optional<T> {
+        if (auto result = rfl::json::read<T>(val); result) {
+            return std::move(result.value());
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    template <typename T>
+    static auto Write(const T& obj) -> std::string {
+        return rfl::json::write(obj);
+    }
+
+    // Same output as Write, but the document is built in a per thread arena and copied into out, reusing its
+    // capacity.
+    template <typename T>
+    static void WriteTo(const T& obj, std::string& out) {
+        if constexpr (detail::ArenaJsonWritable<T>) {
+            WriteToArena(obj, out);
+        } else {
+            out = Write(obj);
+        }
+    }
+
+private:
+    template <typename T>
+    static void WriteToArena(const T& obj, std::string& out) {
+        auto& arena = detail::JsonArena::ForThread();
+        while (true) {
+            arena.Reset();
+            const yyjson_alc alc = arena.allocator();
+            auto writer = rfl::json::Writer(yyjson_mut_doc_new(&alc));
+            if (writer.doc_ != nullptr) {
+                rfl::json::Parser<T, rfl::Processors<>>::write(
+                    writer, obj, typename rfl::parsing::Parent<rfl::json::Writer>::Root{});
+                size_t size = 0;
+                const char* json = yyjson_mut_write_opts(writer.doc_, 0, &alc, &size, nullptr);
+                if (json != nullptr && !arena.exhausted()) {
+                    out.assign(json, size);
+                    arena.Trim();
+                    return;
+                }
+            }
+            // Not a lack of memory or too large for the arena, let reflect-cpp handle it.
+            if (!arena.exhausted() || !arena.Grow()) {
+                out = Write(obj);
+                arena.Trim();
+                return;
+            }
+        }
+    }
+};
+
+#ifdef ORYX_KVDB_MSGPACK
+struct MsgpackCodec {
+    template <typename T>
+    static auto Read(std::string_view val) -> std::optional<T> {
+        if (auto result = rfl::msgpack::read<T>(val.data(), val.size()); result) {
+            return std::move(result.value());
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    template <typename T>
+    static auto Write(const T& obj) -> std::string {
+        const std::vector<char> bytes = rfl::msgpack::write(obj);
+        return std::string(bytes.data(), bytes.size());
+    }
+};
+#endif
+
+#ifdef ORYX_KVDB_CBOR
+struct CborCodec {
+    template <typename T>
+    static auto Read(std::string_view val) -> std::optional<T> {
+        if (auto result = rfl::cbor::read<T>(val.data(), val.size()); result) {
+            return std::move(result.value());
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    template <typename T>
+    static auto Write(const T& obj) -> std::string {
+        const std::vector<char> bytes = rfl::cbor::write(obj);
+        return std::string(bytes.data(), bytes.size());
+    }
+};
+#endif
+
+// How integral and floating point values are stored. Fixed formats prefix the value with a tag byte
+// so text encoded values written before switching formats can still be read.
+enum class NumberFormat : uint8_t {
+    kText,               // decimal text, the default
+    kFixedLittleEndian,  // tag + sizeof(T) bytes little endian
+    kOrderedBigEndian,   // tag + sizeof(T) bytes big endian, sign flipped so bytewise order matches numeric order
+};
+
+// Wraps a codec to store numbers in a fixed width format:
+// oryx::BasicKeyValueDatabase<oryx::WithNumberFormat<oryx::JsonCodec, oryx::NumberFormat::kFixedLittleEndian>>
+template <typename Codec, NumberFormat kFormat>
+struct WithNumberFormat : Codec {
+    static constexpr NumberFormat kNumberFormat = kFormat;
+};
+
+template <typename Codec>
+inline constexpr NumberFormat number_format_v = [] {
+    if constexpr (requires { Codec::kNumberFormat; })
+        return Codec::kNumberFormat;
+    else
+        return NumberFormat::kText;
+}();
+
+// Specialize to pin a type to a codec regardless of the database's codec:
+// template <> struct oryx::value_codec<MyStruct> { using type = oryx::MsgpackCodec; };
+template <typename T>
+struct value_codec {
+    using type = void;
+};
+
+template <typename T, typename Default>
+using value_codec_t =
+    std::conditional_t<std::is_void_v<typename value_codec<T>::type>, Default, typename value_codec<T>::type>;
+
+// Trivially copyable aggregates whose fields are all numbers, bools or enums can be stored in a packed binary
+// layout instead of going through the codec. The layout changes the stored format, so types opt in by specializing:
+// template <> struct oryx::fixed_layout<MyStruct> : std::true_type {};
+// Types pinned to a codec with value_codec stay on it. The layout takes precedence over the codec of the database,
+// so an opted in struct is packed even in a database using MsgpackCodec. Values written by the codec before stay
+// readable and are rewritten in the packed layout by their next Put.
+template <typename T>
+struct fixed_layout : std::false_type {};
+
 namespace detail {
 
 template <typename T, typename... Us>
@@ -20,6 +305,15 @@ struct is_same_r : std::bool_constant<(std::is_same_v<T, Us> || ...)> {};
 template <typename T, typename... Us>
 inline constexpr bool is_same_r_v = is_same_r<T, Us...>::value;
 
+// 64 bit FNV-1a, stable across platforms and runs unlike std::hash.
+constexpr auto Fnv1a(std::string_view data, uint64_t hash = 14695981039346656037ULL) -> uint64_t {
+    for (const char c : data) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
 template <typename T>
 constexpr auto FromChars(std::string_view s) -> std::optional<T> {
     T val;
@@ -30,6 +324,14 @@ constexpr auto FromChars(std::string_view s) -> std::optional<T> {
     }
 }
 
+// Shortest representation that reads back to the exact same value.
+template <typename T>
+void ToChars(T val, std::string& out) {
+    char buffer[64];
+    const auto result = std::to_chars(std::begin(buffer), std::end(buffer), val);
+    out.assign(buffer, result.ptr);
+}
+
 template <>
 constexpr auto FromChars<bool>(std::string_view s) -> std::optional<bool> {
     if (auto val = FromChars<uint8_t>(s); val.has_value())
@@ -38,102 +340,1448 @@ constexpr auto FromChars<bool>(std::string_view s) -> std::optional<bool> {
         return std::nullopt;
 }
 
+// First byte of values that are not stored as text.
+enum class ValueTag : char {
+    kFixedLittleEndian = '\x01',
+    kOrderedBigEndian = '\x02',
+    kFixedLayout = '\x03',
+};
+
+template <typename T>
+inline constexpr bool is_fixed_number_v =
+    (std::is_integral_v<T> && !std::is_same_v<T, bool>) || is_same_r_v<T, float, double>;
+
+template <typename T>
+using fixed_bits_t = std::conditional_t<std::is_floating_point_v<T>,
+                                        std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>,
+                                        std::make_unsigned_t<std::conditional_t<std::is_floating_point_v<T>, int, T>>>;
+
+template <typename U>
+constexpr auto ByteSwap(U val) -> U {
+    U result{};
+    for (size_t i = 0; i < sizeof(U); ++i) {
+        result = static_cast<U>((result << 8) | ((val >> (i * 8)) & 0xFF));
+    }
+    return result;
+}
+
+// Maps a number onto unsigned bits whose unsigned order equals the numeric order.
+template <typename T>
+constexpr auto ToOrderedBits(T val) -> fixed_bits_t<T> {
+    using U = fixed_bits_t<T>;
+    constexpr U kSignBit = U{1} << (sizeof(U) * 8 - 1);
+
+    if constexpr (std::is_floating_point_v<T>) {
+        const U bits = std::bit_cast<U>(val);
+        return (bits & kSignBit) ? static_cast<U>(~bits) : static_cast<U>(bits | kSignBit);
+    } else if constexpr (std::is_signed_v<T>) {
+        return static_cast<U>(static_cast<U>(val) ^ kSignBit);
+    } else {
+        return static_cast<U>(val);
+    }
+}
+
+template <typename T>
+constexpr auto FromOrderedBits(fixed_bits_t<T> bits) -> T {
+    using U = fixed_bits_t<T>;
+    constexpr U kSignBit = U{1} << (sizeof(U) * 8 - 1);
+
+    if constexpr (std::is_floating_point_v<T>) {
+        return std::bit_cast<T>((bits & kSignBit) ? static_cast<U>(bits & ~kSignBit) : static_cast<U>(~bits));
+    } else if constexpr (std::is_signed_v<T>) {
+        return static_cast<T>(static_cast<U>(bits ^ kSignBit));
+    } else {
+        return static_cast<T>(bits);
+    }
+}
+
+template <NumberFormat kFormat, typename T>
+void EncodeNumber(T val, std::string& out) {
+    using U = fixed_bits_t<T>;
+    static_assert(kFormat != NumberFormat::kText);
+
+    U bits{};
+    ValueTag tag{};
+    if constexpr (kFormat == NumberFormat::kFixedLittleEndian) {
+        tag = ValueTag::kFixedLittleEndian;
+        if constexpr (std::is_floating_point_v<T>)
+            bits = std::bit_cast<U>(val);
+        else
+            bits = static_cast<U>(val);
+        if constexpr (std::endian::native == std::endian::big) bits = ByteSwap(bits);
+    } else {
+        tag = ValueTag::kOrderedBigEndian;
+        bits = ToOrderedBits(val);
+        if constexpr (std::endian::native == std::endian::little) bits = ByteSwap(bits);
+    }
+
+    out.resize(1 + sizeof(U));
+    out.front() = static_cast<char>(tag);
+    std::memcpy(out.data() + 1, &bits, sizeof(U));
+}
+
+// Decodes a tagged fixed width number, returns nullopt if val is not one.
+template <typename T>
+auto DecodeNumber(std::string_view val) -> std::optional<T> {
+    using U = fixed_bits_t<T>;
+
+    if (val.size() != 1 + sizeof(U)) {
+        return std::nullopt;
+    }
+
+    U bits;
+    std::memcpy(&bits, val.data() + 1, sizeof(U));
+    switch (static_cast<ValueTag>(val.front())) {
+        case ValueTag::kFixedLittleEndian:
+            if constexpr (std::endian::native == std::endian::big) bits = ByteSwap(bits);
+            if constexpr (std::is_floating_point_v<T>)
+                return std::bit_cast<T>(bits);
+            else
+                return static_cast<T>(bits);
+        case ValueTag::kOrderedBigEndian:
+            if constexpr (std::endian::native == std::endian::little) bits = ByteSwap(bits);
+            return FromOrderedBits<T>(bits);
+        default:
+            return std::nullopt;
+    }
+}
+
+template <typename T>
+inline constexpr bool is_fixed_field_v =
+    !std::is_const_v<T> && (is_fixed_number_v<T> || std::is_same_v<T, bool> || std::is_enum_v<T>);
+
+// Stable name of a field type for the layout hash, enums are identified by their underlying type.
+template <typename T>
+constexpr auto FixedFieldType() -> std::string_view {
+    if constexpr (std::is_enum_v<T>) {
+        return FixedFieldType<std::underlying_type_t<T>>();
+    } else if constexpr (std::is_same_v<T, bool>) {
+        return "b1";
+    } else if constexpr (std::is_floating_point_v<T>) {
+        return sizeof(T) == 4 ? "f4" : "f8";
+    } else if constexpr (std::is_integral_v<T>) {
+        constexpr std::string_view kSigned[] = {"", "i1", "i2", "", "i4", "", "", "", "i8"};
+        constexpr std::string_view kUnsigned[] = {"", "u1", "u2", "", "u4", "", "", "", "u8"};
+        return std::is_signed_v<T> ? kSigned[sizeof(T)] : kUnsigned[sizeof(T)];
+    } else {
+        return "?";
+    }
+}
+
+template <typename NamedTuple>
+struct FixedFields {
+    static constexpr bool kSupported = false;
+};
+
+template <typename... Fs>
+struct FixedFields<rfl::NamedTuple<Fs...>> {
+    static constexpr bool kSupported = sizeof...(Fs) > 0 && (is_fixed_field_v<typename Fs::Type> && ...);
+    static constexpr bool kHasBool = (std::is_same_v<typename Fs::Type, bool> || ...);
+    static constexpr size_t kSize = (size_t{0} + ... + sizeof(typename Fs::Type));
+    // Changes whenever a field is renamed, retyped, added, removed or reordered.
+    static constexpr uint64_t kHash = [] {
+        uint64_t hash = Fnv1a("oryx.fixed_layout");
+        ((hash = Fnv1a(FixedFieldType<typename Fs::Type>(), Fnv1a(Fs::name(), hash))), ...);
+        return hash;
+    }();
+};
+
+template <typename T>
+struct is_std_array : std::false_type {};
+
+template <typename U, size_t N>
+struct is_std_array<std::array<U, N>> : std::true_type {};
+
+// Types reflect-cpp cannot turn into a named tuple, such as std::array, stay on their codec.
+template <typename T>
+consteval auto IsFixedLayout() -> bool {
+    if constexpr (std::is_class_v<T> && std::is_aggregate_v<T> && std::is_trivially_copyable_v<T> &&
+                  !is_std_array<T>::value && fixed_layout<T>::value &&
+                  std::is_void_v<typename value_codec<T>::type>) {
+        if constexpr (requires { typename rfl::named_tuple_t<T>; })
+            return FixedFields<rfl::named_tuple_t<T>>::kSupported;
+        else
+            return false;
+    } else {
+        return false;
+    }
+}
+
+template <typename T>
+inline constexpr bool is_fixed_layout_v = IsFixedLayout<T>();
+
+template <typename T>
+using fixed_fields_t = FixedFields<rfl::named_tuple_t<T>>;
+
+inline constexpr size_t kFixedLayoutHeaderSize = 1 + sizeof(uint64_t);
+
+template <typename T>
+void StoreLittleEndian(T val, char* out) {
+    if constexpr (std::is_enum_v<T>) {
+        StoreLittleEndian(static_cast<std::underlying_type_t<T>>(val), out);
+    } else if constexpr (std::is_same_v<T, bool>) {
+        *out = val ? '\x01' : '\x00';
+    } else {
+        auto bits = std::bit_cast<fixed_bits_t<T>>(val);
+        if constexpr (std::endian::native == std::endian::big) bits = ByteSwap(bits);
+        std::memcpy(out, &bits, sizeof(bits));
+    }
+}
+
+template <typename T>
+auto LoadLittleEndian(const char* in, T& val) -> bool {
+    if constexpr (std::is_enum_v<T>) {
+        std::underlying_type_t<T> underlying{};
+        LoadLittleEndian(in, underlying);
+        val = static_cast<T>(underlying);
+    } else if constexpr (std::is_same_v<T, bool>) {
+        if (static_cast<uint8_t>(*in) > 1) {
+            return false;
+        }
+        val = *in == '\x01';
+    } else {
+        fixed_bits_t<T> bits;
+        std::memcpy(&bits, in, sizeof(bits));
+        if constexpr (std::endian::native == std::endian::big) bits = ByteSwap(bits);
+        val = std::bit_cast<T>(bits);
+    }
+    return true;
+}
+
+// Tag, layout hash and the fields packed in declaration order, little endian. Without padding on a little endian
+// machine that is a single memcpy of obj.
+template <typename T>
+void EncodeFixedLayout(const T& obj, std::string& out) {
+    using Fields = fixed_fields_t<T>;
+
+    out.resize(kFixedLayoutHeaderSize + Fields::kSize);
+    char* data = out.data();
+    data[0] = static_cast<char>(ValueTag::kFixedLayout);
+    StoreLittleEndian(Fields::kHash, data + 1);
+    data += kFixedLayoutHeaderSize;
+
+    if constexpr (std::endian::native == std::endian::little && sizeof(T) == Fields::kSize) {
+        std::memcpy(data, &obj, sizeof(T));
+    } else {
+        T copy = obj;
+        rfl::to_view(copy).apply([&](const auto& field) {
+            StoreLittleEndian(*field.value(), data);
+            data += sizeof(*field.value());
+        });
+    }
+}
+
+// Whether val was written with the current layout of T.
+template <typename T>
+auto HasFixedLayout(std::string_view val) -> bool {
+    using Fields = fixed_fields_t<T>;
+
+    uint64_t hash{};
+    return val.size() == kFixedLayoutHeaderSize + Fields::kSize &&
+           static_cast<ValueTag>(val.front()) == ValueTag::kFixedLayout && LoadLittleEndian(val.data() + 1, hash) &&
+           hash == Fields::kHash;
+}
+
+// Returns nullopt if val was written with a different layout of T.
+template <typename T>
+auto DecodeFixedLayout(std::string_view val) -> std::optional<T> {
+    using Fields = fixed_fields_t<T>;
+
+    if (!HasFixedLayout<T>(val)) {
+        return std::nullopt;
+    }
+
+    T obj{};
+    const char* data = val.data() + kFixedLayoutHeaderSize;
+    if constexpr (std::endian::native == std::endian::little && sizeof(T) == Fields::kSize && !Fields::kHasBool) {
+        std::memcpy(&obj, data, sizeof(T));
+    } else {
+        bool ok = true;
+        rfl::to_view(obj).apply([&](const auto& field) {
+            ok = ok && LoadLittleEndian(data, *field.value());
+            data += sizeof(*field.value());
+        });
+        if (!ok) {
+            return std::nullopt;
+        }
+    }
+    return obj;
+}
+
 template <typename T>
-constexpr auto Read(const std::string& val) -> std::optional<T> {
+auto ReadNumber(std::string_view val) -> std::optional<T> {
+    if constexpr (is_fixed_number_v<T>) {
+        if (auto number = DecodeNumber<T>(val); number) {
+            return number;
+        }
+    }
+    return FromChars<T>(val);
+}
+
+template <typename T, typename Codec = JsonCodec>
+constexpr auto Read(std::string_view val) -> std::optional<T> {
     using _T = std::remove_cvref_t<T>;
 
     if constexpr (std::is_same_v<_T, std::string>)
-        return val;
+        return std::string(val);
     else if constexpr (std::is_same_v<_T, bool>)
         return FromChars<bool>(val);
     else if constexpr (std::is_floating_point_v<_T>)
-        return FromChars<T>(val);
+        return ReadNumber<_T>(val);
     else if constexpr (std::is_integral_v<_T>)
-        return FromChars<T>(val);
-    else {
-        if (auto result = rfl::json::read<T>(val); result) {
-            return result.value();
-        } else {
-            return std::nullopt;
-        }
+        return ReadNumber<_T>(val);
+    else if constexpr (is_fixed_layout_v<_T>)
+        // Values written before the type had a fixed layout are still read with the codec.
+        return !val.empty() && static_cast<ValueTag>(val.front()) == ValueTag::kFixedLayout
+                   ? DecodeFixedLayout<_T>(val)
+                   : value_codec_t<_T, Codec>::template Read<T>(val);
+    else
+        return value_codec_t<_T, Codec>::template Read<T>(val);
+}
+
+// Reads a value that may have been compressed by compressor, a null compressor reads val as is.
+template <typename T, typename Codec = JsonCodec>
+auto Read(std::string_view val, const ValueCompressor* compressor) -> std::optional<T> {
+    if (compressor == nullptr) {
+        return Read<T, Codec>(val);
     }
+    if (auto plain = compressor->Decompress(val); plain) {
+        return Read<T, Codec>(*plain);
+    }
+    return std::nullopt;
 }
 
-template <typename T>
-constexpr auto Write(const T& obj) {
+// Encodes obj into out, reusing its capacity. Codecs can provide WriteTo(obj, out) to do the same.
+template <typename T, typename Codec = JsonCodec>
+void WriteTo(const T& obj, std::string& out) {
     using _T = std::remove_cvref_t<T>;
+    using codec_t = value_codec_t<_T, Codec>;
 
     if constexpr (is_same_r_v<_T, std::string, std::string_view>)
-        return obj;
+        out.assign(obj.data(), obj.size());
     else if constexpr (std::is_same_v<_T, bool>)
-        return std::to_string(static_cast<uint8_t>(obj));
+        out.assign(1, obj ? '1' : '0');
+    else if constexpr (is_fixed_number_v<_T> && number_format_v<codec_t> != NumberFormat::kText)
+        EncodeNumber<number_format_v<codec_t>>(obj, out);
     else if constexpr (std::is_floating_point_v<_T>)
-        return std::to_string(obj);
+        ToChars(obj, out);
     else if constexpr (std::is_integral_v<_T>)
-        return std::to_string(obj);
+        ToChars(obj, out);
+    else if constexpr (is_fixed_layout_v<_T>)
+        EncodeFixedLayout(obj, out);
+    else if constexpr (requires { codec_t::WriteTo(obj, out); })
+        codec_t::WriteTo(obj, out);
     else
-        return rfl::json::write(obj);
+        out = codec_t::Write(obj);
 }
 
-}  // namespace detail
-
-class KeyValueDatabase {
-public:
-    KeyValueDatabase() = default;
+template <typename T, typename Codec = JsonCodec>
+auto Write(const T& obj) -> std::string {
+    std::string out;
+    WriteTo<T, Codec>(obj, out);
+    return out;
+}
 
-    auto Open(const std::string& name, const leveldb::Options& opts = DefaultOptions()) -> leveldb::Status {
-        Close();
+// Returns a slice over the encoded obj, strings are referenced directly and everything else is encoded into buffer.
+template <typename T, typename Codec = JsonCodec>
+auto Encode(const T& obj, std::string& buffer) -> leveldb::Slice {
+    using _T = std::remove_cvref_t<T>;
 
-#ifdef __cpp_lib_out_ptr
-        return leveldb::DB::Open(opts, name, std::out_ptr(handle_));
-#else
-        leveldb::DB* db;
-        const auto status = leveldb::DB::Open(opts, name, &db);
-        if (status.ok()) {
-            handle_ = std::unique_ptr<leveldb::DB>(db);
-        }
-        return status;
-#endif
+    if constexpr (is_same_r_v<_T, std::string, std::string_view>) {
+        return leveldb::Slice(obj.data(), obj.size());
+    } else {
+        WriteTo<T, Codec>(obj, buffer);
+        return leveldb::Slice(buffer);
     }
+}
 
-    void Close() { handle_.reset(); }
+template <typename T>
+struct member_pointer;
 
-    template <typename T>
-    auto Get(const leveldb::Slice& key, T& val, const leveldb::ReadOptions& opts = DefaultReadOptions())
-        -> leveldb::Status {
-        std::string result;
-        leveldb::Status status = handle_->Get(opts, key, &result);
-        if (!status.ok()) {
-            return status;
-        }
+template <typename C, typename M>
+struct member_pointer<M C::*> {
+    using class_type = C;
+    using member_type = M;
+};
 
-        std::optional<T> parsed = detail::Read<T>(result);
-        if (!parsed) {
-            return leveldb::Status::IOError("Parse failed");
-        }
+template <auto Member>
+using member_class_t = typename member_pointer<decltype(Member)>::class_type;
 
-        val = std::move(parsed.value());
-        return status;
-    }
+template <auto Member>
+using member_type_t = typename member_pointer<decltype(Member)>::member_type;
 
-    template <typename T>
-    auto Put(const leveldb::Slice& key, const T& obj, const leveldb::WriteOptions& opts = DefaultWriteOptions())
-        -> leveldb::Status {
-        return handle_->Put(opts, key, detail::Write(obj));
+struct FieldInfo {
+    std::string_view name{};
+    // Offset in the packed fixed layout.
+    size_t offset{0};
+};
+
+// Name and offset of a data member, resolved once by matching its address against the reflected fields.
+template <auto Member>
+auto FieldOf() -> const FieldInfo& {
+    static const FieldInfo info = [] {
+        member_class_t<Member> obj{};
+        FieldInfo result{};
+        bool found = false;
+        rfl::to_view(obj).apply([&](const auto& field) {
+            if (found) {
+                return;
+            }
+            if (static_cast<const void*>(field.value()) == static_cast<const void*>(&(obj.*Member))) {
+                found = true;
+                result.name = field.name();
+            } else {
+                result.offset += sizeof(*field.value());
+            }
+        });
+        return result;
+    }();
+    return info;
+}
+
+inline void SkipJsonWhitespace(std::string_view json, size_t& pos) {
+    while (pos < json.size() && (json[pos] == ' ' || json[pos] == '\n' || json[pos] == '\r' || json[pos] == '\t')) {
+        ++pos;
     }
+}
 
-    auto Delete(const leveldb::Slice& key, const leveldb::WriteOptions& opts = DefaultWriteOptions())
-        -> leveldb::Status {
-        return handle_->Delete(opts, key);
+// Skips the string starting at pos, escapes are not decoded.
+inline auto SkipJsonString(std::string_view json, size_t& pos) -> bool {
+    for (++pos; pos < json.size(); ++pos) {
+        if (json[pos] == '\\') {
+            ++pos;
+        } else if (json[pos] == '"') {
+            ++pos;
+            return true;
+        }
     }
+    return false;
+}
 
-    [[nodiscard]] auto IsOpen() const -> bool { return static_cast<bool>(handle_); }
-    [[nodiscard]] auto handle() const -> leveldb::DB& { return *handle_; }
+// Skips the value starting at pos by matching brackets, nothing is parsed.
+inline auto SkipJsonValue(std::string_view json, size_t& pos) -> bool {
+    if (pos >= json.size()) {
+        return false;
+    }
+    if (json[pos] == '"') {
+        return SkipJsonString(json, pos);
+    }
+    if (json[pos] != '{' && json[pos] != '[') {
+        const size_t begin = pos;
+        while (pos < json.size() && std::string_view(",}] \n\r\t").find(json[pos]) == std::string_view::npos) {
+            ++pos;
+        }
+        return pos != begin;
+    }
 
-    static auto DefaultOptions() -> leveldb::Options {
+    size_t depth = 0;
+    while (pos < json.size()) {
+        switch (json[pos]) {
+            case '"':
+                if (!SkipJsonString(json, pos)) {
+                    return false;
+                }
+                continue;
+            case '{':
+            case '[':
+                ++depth;
+                break;
+            case '}':
+            case ']':
+                if (--depth == 0) {
+                    ++pos;
+                    return true;
+                }
+                break;
+            default:
+                break;
+        }
+        ++pos;
+    }
+    return false;
+}
+
+// Returns the json text of the top level member name without parsing the values of any other member,
+// nullopt if json is not an object or has no such member.
+inline auto FindJsonMember(std::string_view json, std::string_view name) -> std::optional<std::string_view> {
+    size_t pos = 0;
+    SkipJsonWhitespace(json, pos);
+    if (pos >= json.size() || json[pos] != '{') {
+        return std::nullopt;
+    }
+    ++pos;
+
+    while (true) {
+        SkipJsonWhitespace(json, pos);
+        if (pos >= json.size() || json[pos] != '"') {
+            return std::nullopt;
+        }
+        const size_t key_begin = pos + 1;
+        if (!SkipJsonString(json, pos)) {
+            return std::nullopt;
+        }
+        const std::string_view key = json.substr(key_begin, pos - key_begin - 1);
+
+        SkipJsonWhitespace(json, pos);
+        if (pos >= json.size() || json[pos] != ':') {
+            return std::nullopt;
+        }
+        ++pos;
+        SkipJsonWhitespace(json, pos);
+
+        const size_t value_begin = pos;
+        if (!SkipJsonValue(json, pos)) {
+            return std::nullopt;
+        }
+        if (key == name) {
+            return json.substr(value_begin, pos - value_begin);
+        }
+
+        SkipJsonWhitespace(json, pos);
+        if (pos >= json.size() || json[pos] != ',') {
+            return std::nullopt;
+        }
+        ++pos;
+    }
+}
+
+// Decodes a single data member of the object in val. Fixed layout values are read at the member's offset and json
+// is scanned for the member, everything else and members that are not found fall back to decoding the object.
+template <auto Member, typename Codec = JsonCodec>
+auto ReadField(std::string_view val) -> std::optional<member_type_t<Member>> {
+    using C = member_class_t<Member>;
+    using M = member_type_t<Member>;
+
+    if constexpr (is_fixed_layout_v<C>) {
+        if (!val.empty() && static_cast<ValueTag>(val.front()) == ValueTag::kFixedLayout) {
+            M member{};
+            if (!HasFixedLayout<C>(val) ||
+                !LoadLittleEndian(val.data() + kFixedLayoutHeaderSize + FieldOf<Member>().offset, member)) {
+                return std::nullopt;
+            }
+            return member;
+        }
+    }
+
+    if constexpr (std::is_base_of_v<JsonCodec, value_codec_t<C, Codec>>) {
+        if (auto member = FindJsonMember(val, FieldOf<Member>().name); member) {
+            return JsonCodec::Read<M>(*member);
+        }
+    }
+
+    if (auto obj = Read<C, Codec>(val); obj) {
+        return std::move(obj.value().*Member);
+    }
+    return std::nullopt;
+}
+
+inline void ClearScratch(std::string& buffer) { buffer.clear(); }
+inline auto RetainedScratchBytes(const std::string& buffer) -> size_t { return buffer.capacity(); }
+inline void ClearScratch(leveldb::WriteBatch& batch) { batch.Clear(); }
+inline auto RetainedScratchBytes(const leveldb::WriteBatch& batch) -> size_t { return batch.ApproximateSize(); }
+
+// Per thread object reused across calls, so steady state encoding and reading does not allocate. An instance
+// created while another one is alive on the same thread, for example by a Put inside a Get visitor, gets an
+// object of its own instead.
+template <typename T>
+class Scratch {
+public:
+    Scratch() {
+        auto& slot = Slot();
+        if (slot.in_use) {
+            value_ = &owned_.emplace();
+        } else {
+            slot.in_use = true;
+            value_ = &*slot.value;
+            ClearScratch(*value_);
+        }
+    }
+
+    Scratch(const Scratch&) = delete;
+    auto operator=(const Scratch&) -> Scratch& = delete;
+
+    // Large values should not pin their memory on every thread that ever wrote one.
+    ~Scratch() {
+        auto& slot = Slot();
+        if (value_ != &*slot.value) {
+            return;
+        }
+        if (RetainedScratchBytes(*value_) > kMaxRetainedBytes) {
+            slot.value.emplace();
+        }
+        slot.in_use = false;
+    }
+
+    auto get() -> T& { return *value_; }
+
+private:
+    static constexpr size_t kMaxRetainedBytes = 64 * 1024;
+
+    struct PerThread {
+        std::optional<T> value{std::in_place};
+        bool in_use{false};
+    };
+
+    static auto Slot() -> PerThread& {
+        thread_local PerThread slot;
+        return slot;
+    }
+
+    std::optional<T> owned_{};
+    T* value_{nullptr};
+};
+
+// Buffer that values are encoded into before leveldb copies them, and that point reads copy values into.
+using ScratchBuffer = Scratch<std::string>;
+// Batch that single writes go through, leveldb's Put would build a new one per call.
+using ScratchBatch = Scratch<leveldb::WriteBatch>;
+
+// Fixed set of mutexes that keys hash onto, so locking per key needs no allocation and bounded memory.
+class LockStripes {
+public:
+    auto For(std::string_view key) -> std::mutex& {
+        return stripes_[std::hash<std::string_view>{}(key) % kStripes].mutex;
+    }
+
+private:
+    static constexpr size_t kStripes = 64;
+
+    // One cache line each, so threads holding neighbouring stripes do not contend on the line.
+    struct alignas(64) Stripe {
+        std::mutex mutex{};
+    };
+
+    std::array<Stripe, kStripes> stripes_{};
+};
+
+// leveldb::Options only borrows its filter policy, so there is one per bits per key for the lifetime of the process.
+inline auto BloomFilterPolicy(int bits_per_key) -> const leveldb::FilterPolicy* {
+    static std::mutex mutex;
+    static auto* policies = new std::map<int, std::unique_ptr<const leveldb::FilterPolicy>>();
+    std::lock_guard lock(mutex);
+    auto& policy = (*policies)[bits_per_key];
+    if (!policy) {
+        policy.reset(leveldb::NewBloomFilterPolicy(bits_per_key));
+    }
+    return policy.get();
+}
+
+}  // namespace detail
+
+// Per key outcome of a multi key read.
+template <typename T>
+struct GetResult {
+    leveldb::Status status{};
+    T value{};
+};
+
+// One key value pair of a scan, the value is only decoded when asked for.
+// Views are only valid until the scan advances.
+template <typename T, typename Codec = JsonCodec>
+class ScanEntry {
+public:
+    ScanEntry(const leveldb::Slice& key,
+              const leveldb::Slice& value,
+              const detail::ValueCompressor* compressor = nullptr)
+        : key_(key.data(), key.size()),
+          value_(value.data(), value.size()),
+          compressor_(compressor) {}
+
+    [[nodiscard]] auto key() const -> std::string_view { return key_; }
+    // Stored bytes, compressed values are not decompressed.
+    [[nodiscard]] auto bytes() const -> std::string_view { return value_; }
+    [[nodiscard]] auto value() const -> std::optional<T> { return detail::Read<T, Codec>(value_, compressor_); }
+
+private:
+    std::string_view key_;
+    std::string_view value_;
+    const detail::ValueCompressor* compressor_;
+};
+
+// Input range over the keys of a leveldb iterator that stops at an exclusive upper bound or at the end of a prefix.
+// A scan that could not flush buffered writes first is empty and reports the error through status().
+template <typename T, typename Codec = JsonCodec>
+class ScanRange {
+public:
+    class Iterator {
+    public:
+        using iterator_concept = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = ScanEntry<T, Codec>;
+
+        Iterator() = default;
+        explicit Iterator(ScanRange* range)
+            : range_(range) {}
+
+        auto operator*() const -> value_type {
+            return value_type(range_->it_->key(), range_->it_->value(), range_->compressor_.get());
+        }
+
+        auto operator++() -> Iterator& {
+            range_->Advance();
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        friend auto operator==(const Iterator& it, std::default_sentinel_t) -> bool { return it.AtEnd(); }
+
+    private:
+        auto AtEnd() const -> bool { return !range_->valid_; }
+
+        ScanRange* range_{nullptr};
+    };
+
+    ScanRange(std::unique_ptr<leveldb::Iterator> it,
+              const leveldb::Comparator* comparator,
+              const leveldb::Slice& start,
+              const leveldb::Slice& limit,
+              const leveldb::Slice& prefix,
+              std::shared_ptr<const detail::ValueCompressor> compressor = nullptr,
+              leveldb::Status flush_status = leveldb::Status::OK())
+        : it_(std::move(it)),
+          comparator_(comparator),
+          start_(start.ToString()),
+          limit_(limit.ToString()),
+          prefix_(prefix.ToString()),
+          compressor_(std::move(compressor)),
+          flush_status_(std::move(flush_status)) {}
+
+    // Seeks to the start on the first call, a scan can only be iterated once.
+    auto begin() -> Iterator {
+        if (!started_ && flush_status_.ok()) {
+            started_ = true;
+            it_->Seek(start_);
+            UpdateValid();
+        }
+        return Iterator(this);
+    }
+
+    auto end() const -> std::default_sentinel_t { return {}; }
+
+    // Error of the flush before the scan or of the underlying iterator, check it after iterating.
+    [[nodiscard]] auto status() const -> leveldb::Status { return flush_status_.ok() ? it_->status() : flush_status_; }
+
+private:
+    void Advance() {
+        it_->Next();
+        UpdateValid();
+    }
+
+    void UpdateValid() {
+        SkipReserved();
+        valid_ = it_->Valid() && (limit_.empty() || comparator_->Compare(it_->key(), limit_) < 0) &&
+                 it_->key().starts_with(prefix_);
+    }
+
+    // Dictionaries are stored next to the values they compress but are not entries of the keyspace.
+    void SkipReserved() {
+#ifdef ORYX_KVDB_ZSTD
+        const leveldb::Slice reserved(detail::kDictionaryKeyPrefix.data(), detail::kDictionaryKeyPrefix.size());
+        while (it_->Valid() && it_->key().starts_with(reserved)) {
+            it_->Next();
+        }
+#endif
+    }
+
+    std::unique_ptr<leveldb::Iterator> it_;
+    const leveldb::Comparator* comparator_;
+    std::string start_;
+    std::string limit_;
+    std::string prefix_;
+    std::shared_ptr<const detail::ValueCompressor> compressor_;
+    leveldb::Status flush_status_;
+    bool started_{false};
+    bool valid_{false};
+};
+
+// Collects typed puts and deletes that are applied atomically by BasicKeyValueDatabase::Write.
+template <typename Codec = JsonCodec>
+class BasicWriteBatch {
+public:
+    using codec_type = Codec;
+
+    BasicWriteBatch() = default;
+
+    template <typename T>
+    void Put(const leveldb::Slice& key, const T& obj) {
+        detail::ScratchBuffer buffer{};
+        batch_.Put(key, detail::Encode<T, Codec>(obj, buffer.get()));
+    }
+
+    void Delete(const leveldb::Slice& key) { batch_.Delete(key); }
+
+    void Clear() { batch_.Clear(); }
+
+    // Size of the encoded batch in bytes, useful for flushing once a threshold is reached.
+    [[nodiscard]] auto ApproximateSize() const -> size_t { return batch_.ApproximateSize(); }
+    [[nodiscard]] auto handle() -> leveldb::WriteBatch& { return batch_; }
+    [[nodiscard]] auto handle() const -> const leveldb::WriteBatch& { return batch_; }
+
+private:
+    leveldb::WriteBatch batch_{};
+};
+
+using WriteBatch = BasicWriteBatch<>;
+
+template <typename Codec = JsonCodec, StorageBackend Backend = LevelDbBackend>
+class BasicKeyValueDatabase {
+public:
+    using codec_type = Codec;
+    using backend_type = Backend;
+    using write_batch_type = BasicWriteBatch<Codec>;
+
+    BasicKeyValueDatabase() = default;
+
+    auto Open(const std::string& name, const leveldb::Options& opts = DefaultOptions()) -> leveldb::Status {
+        Close();
+
+        leveldb::Options effective = opts;
+        std::unique_ptr<ResourceManager::Lease> lease{};
+        if (resources_) {
+            lease = resources_->Acquire(effective);
+        }
+        const auto status = Backend::Open(effective, name, handle_);
+        if (status.ok()) {
+            lease_ = std::move(lease);
+        }
+        if (status.ok() && durability_ == Durability::kGroupCommit) {
+            committer_ = std::make_unique<detail::GroupCommitter>(*handle_, group_commit_opts_);
+        }
+        if (status.ok() && write_behind_opts_) {
+            StartWriteBehind();
+        }
+        if (status.ok() && async_opts_) {
+            StartAsync();
+        }
+        comparator_ = opts.comparator;
+        if (cache_) {
+            cache_->Clear();
+        }
+        if (negative_) {
+            negative_->Clear();
+        }
+        // Dictionaries belong to the database they are stored in.
+        compressors_.clear();
+#ifdef ORYX_KVDB_ZSTD
+        dictionaries_.clear();
+#endif
+        return status;
+    }
+
+    // Waits for pending async operations and flushes buffered writes.
+    void Close() {
+        async_.reset();
+        write_behind_.reset();
+        committer_.reset();
+        handle_.reset();
+        lease_.reset();
+    }
+
+    // Opens with the shared block cache of manager and a share of its write buffer and open files budgets instead
+    // of the cache, write_buffer_size and max_open_files of the options, see ResourceManager.
+    // Takes effect on the next Open and is kept across Close and Open.
+    void EnableSharedResources(ResourceManager& manager = ResourceManager::Default()) { resources_ = &manager; }
+    void DisableSharedResources() { resources_ = nullptr; }
+
+    // In group commit mode writes ignore WriteOptions::sync and return once they are in the log,
+    // use Durable() to wait for them to reach the disk. Kept across Close and Open.
+    // Must not be called concurrently with writes.
+    void SetDurability(Durability mode, const GroupCommitOptions& opts = {}) {
+        committer_.reset();
+        durability_ = mode;
+        group_commit_opts_ = opts;
+        if (IsOpen() && durability_ == Durability::kGroupCommit) {
+            committer_ = std::make_unique<detail::GroupCommitter>(*handle_, group_commit_opts_);
+        }
+    }
+
+    // Becomes ready once all writes acknowledged so far are synced, always ready in sync mode.
+    auto Durable() -> std::shared_future<leveldb::Status> {
+        if (committer_) {
+            return committer_->Durable();
+        }
+        std::promise<leveldb::Status> ready;
+        ready.set_value(leveldb::Status::OK());
+        return ready.get_future().share();
+    }
+
+    [[nodiscard]] auto durability() const -> Durability { return durability_; }
+
+    // Caches deserialized objects per (key, type) so hot reads skip leveldb and the codec.
+    // Put, Delete and Write invalidate it, writes that go around this class through handle() do not.
+    // Must not be called concurrently with other operations.
+    void EnableObjectCache(const ObjectCacheOptions& opts = {}) { cache_ = std::make_unique<ObjectCache>(opts); }
+    void DisableObjectCache() { cache_.reset(); }
+    [[nodiscard]] auto object_cache() const -> ObjectCache* { return cache_.get(); }
+
+    // Remembers keys that point reads, MultiGet and Contains found missing and answers further reads of them
+    // without a lookup. Put, Delete and Write forget them, writes that go around this class through handle() do not.
+    // Must not be called concurrently with other operations.
+    void EnableNegativeCache(const NegativeCacheOptions& opts = {}) {
+        negative_ = std::make_unique<NegativeCache>(opts);
+    }
+    void DisableNegativeCache() { negative_.reset(); }
+    [[nodiscard]] auto negative_cache() const -> NegativeCache* { return negative_.get(); }
+
+    // Buffers Put, Delete and Write in memory and writes only the latest value per key, as one batch every
+    // opts.interval or once opts.max_buffered_bytes are buffered. Point reads see buffered writes, scans flush them
+    // first and snapshot reads do not see them. A buffered write is acknowledged before it is in the log and is
+    // lost on a crash, Durable() does not cover it. Kept across Close and Open, which flush.
+    // Must not be called concurrently with other operations, and the database must not be moved while enabled.
+    void EnableWriteBehind(const WriteBehindOptions& opts = {}) {
+        write_behind_.reset();
+        write_behind_opts_ = opts;
+        if (IsOpen()) {
+            StartWriteBehind();
+        }
+    }
+
+    auto DisableWriteBehind() -> leveldb::Status {
+        const auto status = Flush();
+        write_behind_.reset();
+        write_behind_opts_.reset();
+        return status;
+    }
+
+    // Writes the buffered writes now, OK without write behind.
+    auto Flush() -> leveldb::Status { return write_behind_ ? write_behind_->FlushBuffered() : leveldb::Status::OK(); }
+
+#ifdef ORYX_KVDB_ZSTD
+    // Compresses values of T written by Put with the latest zstd dictionary trained under name, several types may
+    // share a dictionary. Values written before, through write batches or that do not shrink are stored as is and
+    // stay readable. Registrations are dropped by Open. Must not be called concurrently with other operations.
+    template <typename T>
+        requires(!std::is_arithmetic_v<T> && !detail::is_same_r_v<T, std::string, std::string_view>)
+    auto RegisterDictionary(const std::string& name, const DictionaryOptions& opts = {}) -> leveldb::Status {
+        auto [dictionary, status] = DictionaryFor(name, opts);
+        if (status.ok()) {
+            compressors_.insert_or_assign(typeid(T), std::move(dictionary));
+        }
+        return status;
+    }
+
+    // Trains a new version of the dictionary name from values stored under prefix and stores it under a reserved
+    // key starting with '\0'. Later writes of registered types use it, values compressed with older versions
+    // can still be read.
+    auto TrainDictionary(const std::string& name, const leveldb::Slice& prefix, const DictionaryOptions& opts = {})
+        -> leveldb::Status {
+        auto [dictionary, status] = DictionaryFor(name, opts);
+        if (!status.ok()) {
+            return status;
+        }
+
+        if (auto flushed = Flush(); !flushed.ok()) {
+            return flushed;
+        }
+        std::vector<std::string> samples;
+        std::unique_ptr<leveldb::Iterator> it(handle_->NewIterator(BulkReadOptions()));
+        for (it->Seek(prefix); it->Valid() && it->key().starts_with(prefix) && samples.size() < opts.max_samples;
+             it->Next()) {
+            if (it->key().starts_with(leveldb::Slice(detail::kDictionaryKeyPrefix.data(),
+                                                     detail::kDictionaryKeyPrefix.size()))) {
+                continue;
+            }
+            if (auto plain = dictionary->Decompress(std::string_view(it->value().data(), it->value().size()));
+                plain) {
+                samples.emplace_back(*plain);
+            }
+        }
+        if (!it->status().ok()) {
+            return it->status();
+        }
+
+        auto trained = detail::TrainZstdDictionary(samples, opts.max_dictionary_bytes);
+        if (!trained) {
+            return leveldb::Status::InvalidArgument(name, "could not train a dictionary, sample more values");
+        }
+
+        const uint32_t version = dictionary->latest_version() + 1;
+        status = handle_->Put(WriteOptionsFor(DefaultWriteOptions()), detail::DictionaryKey(name, version), *trained);
+        Written(status, trained->size());
+        if (status.ok() && !dictionary->AddVersion(version, *trained)) {
+            return leveldb::Status::Corruption(name, "trained dictionary could not be loaded");
+        }
+        return status;
+    }
+#endif
+
+    template <typename T>
+        requires(!std::invocable<T&, std::string_view>)
+    auto Get(const leveldb::Slice& key, T& val, const leveldb::ReadOptions& opts = DefaultReadOptions())
+        -> leveldb::Status {
+        detail::Stopwatch watch{};
+        std::string result;
+        const auto buffered = FindBuffered(key, opts, result);
+        if (!buffered && UseCache(opts)) {
+            std::shared_ptr<const T> cached;
+            const auto status = GetShared(key, cached, opts);
+            if (status.ok()) {
+                val = *cached;
+            }
+            return status;
+        }
+
+        leveldb::Status status = buffered ? *buffered : GetFromEngine(key, opts, result);
+        const uint64_t engine_nanos = watch.Lap();
+        if (!status.ok()) {
+            metrics_.Record(detail::Operation::kGet, key.size(), engine_nanos);
+            return status;
+        }
+
+        std::optional<T> parsed = detail::Read<T, Codec>(result, CompressorFor<T>());
+        metrics_.Record(detail::Operation::kGet, key.size() + result.size(), engine_nanos, watch.Lap());
+        if (!parsed) {
+            metrics_.RecordParseFailure();
+            return leveldb::Status::IOError("Parse failed");
+        }
+
+        val = std::move(parsed.value());
+        return status;
+    }
+
+    // Like Get but shares the object, with the object cache enabled hot keys are returned without a copy.
+    template <typename T>
+    auto GetShared(const leveldb::Slice& key,
+                   std::shared_ptr<const T>& val,
+                   const leveldb::ReadOptions& opts = DefaultReadOptions()) -> leveldb::Status {
+        const std::string_view key_view(key.data(), key.size());
+        detail::Stopwatch watch{};
+        std::string result;
+        const auto buffered = FindBuffered(key, opts, result);
+        const bool use_cache = !buffered && UseCache(opts);
+        uint64_t generation = 0;
+        if (use_cache) {
+            if (auto cached = cache_->Lookup<T>(key_view); cached) {
+                val = std::move(cached);
+                metrics_.RecordCacheHit();
+                return leveldb::Status::OK();
+            }
+            generation = cache_->Generation(key_view);
+        }
+
+        leveldb::Status status = buffered ? *buffered : GetFromEngine(key, opts, result);
+        const uint64_t engine_nanos = watch.Lap();
+        if (!status.ok()) {
+            metrics_.Record(detail::Operation::kGet, key.size(), engine_nanos);
+            return status;
+        }
+
+        std::optional<T> parsed = detail::Read<T, Codec>(result, CompressorFor<T>());
+        metrics_.Record(detail::Operation::kGet, key.size() + result.size(), engine_nanos, watch.Lap());
+        if (!parsed) {
+            metrics_.RecordParseFailure();
+            return leveldb::Status::IOError("Parse failed");
+        }
+
+        val = std::make_shared<const T>(std::move(parsed.value()));
+        if (use_cache) {
+            cache_->Insert(key_view, val, result.size(), generation);
+        }
+        return status;
+    }
+
+    // Reads a single data member of the object stored under key without decoding the rest of it:
+    // uint32_t version = 0;
+    // db.GetField<&MyStruct::version>("myKey", version);
+    template <auto Member>
+    auto GetField(const leveldb::Slice& key,
+                  detail::member_type_t<Member>& val,
+                  const leveldb::ReadOptions& opts = DefaultReadOptions()) -> leveldb::Status {
+        using C = detail::member_class_t<Member>;
+
+        std::string result;
+        const auto buffered = FindBuffered(key, opts, result);
+        if (!buffered && UseCache(opts)) {
+            if (auto cached = cache_->Lookup<C>(std::string_view(key.data(), key.size())); cached) {
+                val = (*cached).*Member;
+                return leveldb::Status::OK();
+            }
+        }
+
+        leveldb::Status status = buffered ? *buffered : GetFromEngine(key, opts, result);
+        if (!status.ok()) {
+            return status;
+        }
+
+        std::optional<std::string_view> plain = result;
+        if (const auto* compressor = CompressorFor<C>(); compressor) {
+            plain = compressor->Decompress(result);
+        }
+
+        auto parsed = plain ? detail::ReadField<Member, Codec>(*plain) : std::nullopt;
+        if (!parsed) {
+            return leveldb::Status::IOError("Parse failed");
+        }
+
+        val = std::move(parsed.value());
+        return status;
+    }
+
+    // Reads many keys with sorted forward seeks over a single iterator so block reads are shared between
+    // neighbouring keys. Results are in the order of keys. With EnableAsync and max_threads > 1 large key sets are
+    // split into contiguous key ranges that the async workers and the calling thread read in parallel from the same
+    // snapshot, without EnableAsync all keys are read on the calling thread. The calling thread reads every range no
+    // worker has picked up yet, so calling this from an async worker cannot wait on its own queue. Backends without
+    // snapshots such as MemoryBackend read the latest data instead, so concurrent writes may be seen by some ranges
+    // and not others.
+    template <typename T>
+    auto MultiGet(std::span<const leveldb::Slice> keys,
+                  const leveldb::ReadOptions& opts = DefaultReadOptions(),
+                  size_t max_threads = 1) -> std::vector<GetResult<T>> {
+        std::vector<GetResult<T>> results(keys.size());
+        std::vector<uint64_t> generations(keys.size());
+        std::vector<uint64_t> missing_generations(UseNegativeCache(opts) ? keys.size() : 0);
+        std::vector<size_t> order;
+        order.reserve(keys.size());
+
+        const bool use_cache = UseCache(opts);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (auto buffered = FindBufferedResult<T>(keys[i], opts); buffered) {
+                results[i] = std::move(*buffered);
+                continue;
+            }
+            if (KnownMissing(keys[i], opts)) {
+                results[i].status = leveldb::Status::NotFound(leveldb::Slice());
+                continue;
+            }
+            if (use_cache) {
+                const std::string_view key(keys[i].data(), keys[i].size());
+                if (auto cached = cache_->Lookup<T>(key); cached) {
+                    results[i].value = *cached;
+                    continue;
+                }
+                generations[i] = cache_->Generation(key);
+            }
+            if (!missing_generations.empty()) {
+                missing_generations[i] = negative_->Generation(std::string_view(keys[i].data(), keys[i].size()));
+            }
+            order.push_back(i);
+        }
+
+        std::sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+            return comparator_->Compare(keys[lhs], keys[rhs]) < 0;
+        });
+
+        leveldb::ReadOptions read_opts = opts;
+        const leveldb::Snapshot* snapshot = nullptr;
+        const size_t chunks = async_ ? std::clamp<size_t>(order.size() / kMinKeysPerMultiGetThread, 1,
+                                                          std::max<size_t>(max_threads, 1))
+                                     : 1;
+        if (chunks > 1 && read_opts.snapshot == nullptr) {
+            snapshot = handle_->GetSnapshot();
+            read_opts.snapshot = snapshot;
+        }
+
+        auto read_range = [&](size_t begin, size_t end) {
+            MultiGetSorted(keys, std::span(order).subspan(begin, end - begin), results, generations, read_opts,
+                           use_cache);
+        };
+
+        if (chunks == 1) {
+            read_range(0, order.size());
+        } else {
+            // Workers and the calling thread claim ranges until none are left. A task that runs after all ranges
+            // were claimed only touches the shared state, everything else outlives the ranges being read.
+            struct Claims {
+                std::atomic<size_t> next{0};
+                std::mutex mutex{};
+                std::condition_variable finished{};
+                size_t done{0};
+            };
+            auto claims = std::make_shared<Claims>();
+            const size_t chunk_size = (order.size() + chunks - 1) / chunks;
+            auto read_claimed = [claims, chunks, chunk_size, size = order.size(), &read_range] {
+                for (size_t chunk = claims->next++; chunk < chunks; chunk = claims->next++) {
+                    read_range(std::min(chunk * chunk_size, size), std::min((chunk + 1) * chunk_size, size));
+                    std::lock_guard lock(claims->mutex);
+                    if (++claims->done == chunks) {
+                        claims->finished.notify_all();
+                    }
+                }
+            };
+            for (size_t i = 1; i < chunks; ++i) {
+                std::function<void()> task = read_claimed;
+                if (!async_->pool.TrySubmit(task)) {
+                    break;
+                }
+            }
+            read_claimed();
+            std::unique_lock lock(claims->mutex);
+            claims->finished.wait(lock, [&] { return claims->done == chunks; });
+        }
+
+        if (snapshot) {
+            handle_->ReleaseSnapshot(snapshot);
+        }
+        if (!missing_generations.empty()) {
+            for (const size_t index : order) {
+                if (results[index].status.IsNotFound()) {
+                    negative_->Insert(std::string_view(keys[index].data(), keys[index].size()),
+                                      missing_generations[index]);
+                }
+            }
+        }
+        return results;
+    }
+
+    // Scans [begin, end) in key order, an empty end scans to the last key.
+    template <typename T>
+    auto Scan(const leveldb::Slice& begin,
+              const leveldb::Slice& end,
+              const leveldb::ReadOptions& opts = DefaultReadOptions()) -> ScanRange<T, Codec> {
+        auto flushed = Flush();
+        return ScanRange<T, Codec>(std::unique_ptr<leveldb::Iterator>(handle_->NewIterator(opts)), comparator_, begin,
+                                   end, leveldb::Slice(), SharedCompressorFor<T>(), std::move(flushed));
+    }
+
+    // Scans all keys starting with prefix in key order.
+    template <typename T>
+    auto ScanPrefix(const leveldb::Slice& prefix, const leveldb::ReadOptions& opts = DefaultReadOptions())
+        -> ScanRange<T, Codec> {
+        auto flushed = Flush();
+        return ScanRange<T, Codec>(std::unique_ptr<leveldb::Iterator>(handle_->NewIterator(opts)), comparator_, prefix,
+                                   leveldb::Slice(), prefix, SharedCompressorFor<T>(), std::move(flushed));
+    }
+
+    // Hands fn a view of the stored bytes, which are copied into a per thread buffer that is reused across calls.
+    // Reads answered from the memtable or the write behind buffer then do not allocate for values up to the 64 KiB
+    // the buffer keeps, reads from table files still allocate inside leveldb. The view is only valid inside fn.
+    template <typename Fn>
+        requires std::invocable<Fn&, std::string_view>
+    auto Get(const leveldb::Slice& key, Fn&& fn, const leveldb::ReadOptions& opts = DefaultReadOptions())
+        -> leveldb::Status {
+        detail::ScratchBuffer buffer{};
+        std::string& value = buffer.get();
+        const auto buffered = FindBuffered(key, opts, value);
+        const auto status = buffered ? *buffered : GetFromEngine(key, opts, value);
+        if (status.ok()) {
+            std::invoke(fn, std::string_view(value));
+        }
+        return status;
+    }
+
+    // Whether key exists, read errors count as missing. With the bloom filter of DefaultOptions most missing keys
+    // are answered without reading a data block, and with the negative cache repeated misses without a lookup.
+    // The value is copied into the per thread buffer of the visiting Get and discarded.
+    auto Contains(const leveldb::Slice& key, const leveldb::ReadOptions& opts = DefaultReadOptions()) -> bool {
+        return Get(key, [](std::string_view) {}, opts).ok();
+    }
+
+    template <typename T>
+    auto Put(const leveldb::Slice& key, const T& obj, const leveldb::WriteOptions& opts = DefaultWriteOptions())
+        -> leveldb::Status {
+        detail::Stopwatch watch{};
+        detail::ScratchBuffer buffer{};
+        const leveldb::Slice value = EncodeValue(obj, buffer.get());
+        const uint64_t codec_nanos = watch.Lap();
+        const auto status = PutEncoded(key, value, opts);
+        metrics_.Record(detail::Operation::kPut, key.size() + value.size(), watch.Lap(), codec_nanos);
+        return status;
+    }
+
+    // Reads the object under key, lets fn modify it and writes it back, atomically with respect to other Updates
+    // of the key. Put, Delete and Write do not take part in the locking. A missing key starts out as T{}, fn may
+    // return false to skip the write:
+    // db.Update<Counter>("hits", [](Counter& counter) { ++counter.value; });
+    // Keys hash onto a fixed set of locks, updates of different keys rarely wait for each other. The read is
+    // served by the object cache if enabled and the updated object is cached. With async operations enabled the
+    // write joins the coalesced batch of concurrent writers, Update must then not run on an async worker.
+    template <typename T, typename Fn>
+        requires std::invocable<Fn&, T&>
+    auto Update(const leveldb::Slice& key, Fn&& fn, const leveldb::WriteOptions& opts = DefaultWriteOptions())
+        -> leveldb::Status {
+        std::lock_guard lock(update_locks_->For(std::string_view(key.data(), key.size())));
+
+        T obj{};
+        if (auto status = Get(key, obj); !status.ok() && !status.IsNotFound()) {
+            return status;
+        }
+        if constexpr (std::is_convertible_v<std::invoke_result_t<Fn&, T&>, bool>) {
+            if (!std::invoke(fn, obj)) {
+                return leveldb::Status::OK();
+            }
+        } else {
+            std::invoke(fn, obj);
+        }
+        return WriteUpdated(key, std::move(obj), opts);
+    }
+
+    auto Delete(const leveldb::Slice& key, const leveldb::WriteOptions& opts = DefaultWriteOptions())
+        -> leveldb::Status {
+        detail::Stopwatch watch{};
+        leveldb::Status status{};
+        if (write_behind_) {
+            status = write_behind_->Delete(std::string_view(key.data(), key.size()), opts.sync);
+        } else {
+            status = handle_->Delete(WriteOptionsFor(opts), key);
+            Written(status, key.size());
+        }
+        Invalidate(key);
+        metrics_.Record(detail::Operation::kDelete, key.size(), watch.Lap());
+        return status;
+    }
+
+    // Applies all updates in batch atomically with a single write to the log.
+    auto Write(write_batch_type& batch, const leveldb::WriteOptions& opts = DefaultWriteOptions()) -> leveldb::Status {
+        if (write_behind_) {
+            const auto status = write_behind_->Write(batch.handle(), opts.sync);
+            Invalidate(batch.handle());
+            return status;
+        }
+        const auto status = handle_->Write(WriteOptionsFor(opts), &batch.handle());
+        Written(status, batch.ApproximateSize());
+        Invalidate(batch.handle());
+        return status;
+    }
+
+    // Runs async operations on opts.threads workers. Async writes are appended to a shared batch that one worker
+    // writes while the previous batch is synced, so concurrent writers share an fsync. Kept across Close and Open.
+    // Must not be called concurrently with other operations, and the database must not be moved while async
+    // operations are pending.
+    void EnableAsync(const AsyncOptions& opts = {}) {
+        async_.reset();
+        async_opts_ = opts;
+        if (IsOpen()) {
+            StartAsync();
+        }
+    }
+
+    // Waits for pending async operations.
+    void DisableAsync() {
+        async_.reset();
+        async_opts_.reset();
+    }
+
+    // Encodes obj on the calling thread, the future becomes ready once the coalesced batch holding it was written.
+    // With write behind enabled async writes are buffered right away like Put and Delete.
+    template <typename T>
+    auto PutAsync(const leveldb::Slice& key,
+                  const T& obj,
+                  const leveldb::WriteOptions& opts = DefaultWriteOptions()) -> std::future<leveldb::Status> {
+        if (!async_) {
+            return AsyncNotEnabled<leveldb::Status>();
+        }
+        if (write_behind_) {
+            return Ready(Put(key, obj, opts));
+        }
+        detail::ScratchBuffer buffer{};
+        const leveldb::Slice value = EncodeValue(obj, buffer.get());
+        return async_->writes.Put(std::string_view(key.data(), key.size()),
+                                  std::string_view(value.data(), value.size()), opts.sync);
+    }
+
+    auto DeleteAsync(const leveldb::Slice& key, const leveldb::WriteOptions& opts = DefaultWriteOptions())
+        -> std::future<leveldb::Status> {
+        if (!async_) {
+            return AsyncNotEnabled<leveldb::Status>();
+        }
+        if (write_behind_) {
+            return Ready(Delete(key, opts));
+        }
+        return async_->writes.Delete(std::string_view(key.data(), key.size()), opts.sync);
+    }
+
+    // Reads on a worker together with the other async reads submitted meanwhile, which share one sorted pass over
+    // an iterator. Async writes are only visible once their future is ready.
+    template <typename T>
+    auto GetAsync(const leveldb::Slice& key, const leveldb::ReadOptions& opts = DefaultReadOptions())
+        -> std::future<GetResult<T>> {
+        if (!async_) {
+            return AsyncNotEnabled<GetResult<T>>();
+        }
+        auto promise = std::make_shared<std::promise<GetResult<T>>>();
+        auto result = promise->get_future();
+        StartGet<T>(key.ToString(), opts, [promise](GetResult<T> read) { promise->set_value(std::move(read)); });
+        return result;
+    }
+
+    // Coroutine interface over the async operations, needs EnableAsync. The awaiting coroutine is resumed through
+    // executor, for example the scheduler of the calling event loop, or without one as a task of its own on the
+    // async workers, never inline on the worker that finished the operation:
+    // oryx::GetResult<MyStruct> result = co_await db.CoGet<MyStruct>("myKey", scheduler);
+    template <typename T>
+    auto CoGet(const leveldb::Slice& key, const leveldb::ReadOptions& opts = DefaultReadOptions())
+        -> Awaitable<GetResult<T>> {
+        return AwaitGet<T>(key, {}, opts);
+    }
+
+    template <typename T, Executor E>
+    auto CoGet(const leveldb::Slice& key, E& executor, const leveldb::ReadOptions& opts = DefaultReadOptions())
+        -> Awaitable<GetResult<T>> {
+        return AwaitGet<T>(key, Awaitable<GetResult<T>>::ResumeOn(executor), opts);
+    }
+
+    template <typename T>
+    auto CoPut(const leveldb::Slice& key, const T& obj, const leveldb::WriteOptions& opts = DefaultWriteOptions())
+        -> Awaitable<leveldb::Status> {
+        return AwaitPut(key, obj, {}, opts);
+    }
+
+    template <typename T, Executor E>
+    auto CoPut(const leveldb::Slice& key,
+               const T& obj,
+               E& executor,
+               const leveldb::WriteOptions& opts = DefaultWriteOptions()) -> Awaitable<leveldb::Status> {
+        return AwaitPut(key, obj, Awaitable<leveldb::Status>::ResumeOn(executor), opts);
+    }
+
+    auto CoDelete(const leveldb::Slice& key, const leveldb::WriteOptions& opts = DefaultWriteOptions())
+        -> Awaitable<leveldb::Status> {
+        return AwaitDelete(key, {}, opts);
+    }
+
+    template <Executor E>
+    auto CoDelete(const leveldb::Slice& key, E& executor, const leveldb::WriteOptions& opts = DefaultWriteOptions())
+        -> Awaitable<leveldb::Status> {
+        return AwaitDelete(key, Awaitable<leveldb::Status>::ResumeOn(executor), opts);
+    }
+
+    // Latencies and counters of Get, GetShared, Put and Delete since construction, split into time spent in the
+    // engine and in the codec. Empty unless built with ORYX_KVDB_METRICS, without it nothing is measured.
+    [[nodiscard]] auto Metrics() const -> DatabaseMetrics { return metrics_.Snapshot(); }
+
+    // Files, sizes in bytes and compaction traffic per level and memory usage of the engine, parsed from the leveldb
+    // properties. See StatsSampler to take samples periodically.
+    auto Stats(EngineStats& stats) const -> leveldb::Status {
+        stats = EngineStats{};
+        std::string value;
+        if (!handle_->GetProperty("leveldb.stats", &value) || !detail::ParseLevelStats(value, stats)) {
+            return leveldb::Status::NotSupported("leveldb.stats could not be read");
+        }
+        // leveldb.stats rounds sizes to whole megabytes, the file list has them in bytes.
+        if (!handle_->GetProperty("leveldb.sstables", &value) || !detail::ParseTableSizes(value, stats)) {
+            return leveldb::Status::NotSupported("leveldb.sstables could not be read");
+        }
+        for (size_t level = 0; level < EngineStats::kLevels; ++level) {
+            if (handle_->GetProperty("leveldb.num-files-at-level" + std::to_string(level), &value)) {
+                stats.levels[level].files = detail::FromChars<uint64_t>(value).value_or(stats.levels[level].files);
+            }
+        }
+        if (handle_->GetProperty("leveldb.approximate-memory-usage", &value)) {
+            stats.approximate_memory_usage = detail::FromChars<uint64_t>(value).value_or(0);
+        }
+        return leveldb::Status::OK();
+    }
+
+    [[nodiscard]] auto IsOpen() const -> bool { return static_cast<bool>(handle_); }
+    [[nodiscard]] auto handle() const -> leveldb::DB&
+        requires std::same_as<Backend, LevelDbBackend>
+    {
+        return handle_->handle();
+    }
+    [[nodiscard]] auto backend() const -> Backend& { return *handle_; }
+
+    static constexpr int kDefaultBloomBitsPerKey = 10;
+
+    // Tables get a bloom filter with bloom_bits_per_key bits per key, 0 disables it. 10 bits per key keep false
+    // positives around 1%, so reads of missing keys rarely touch a data block. Tables written before keep the
+    // filter they were written with.
+    static auto DefaultOptions(int bloom_bits_per_key = kDefaultBloomBitsPerKey) -> leveldb::Options {
         leveldb::Options opts{};
         opts.create_if_missing = true;
         opts.reuse_logs = true;
+        opts.filter_policy = bloom_bits_per_key > 0 ? detail::BloomFilterPolicy(bloom_bits_per_key) : nullptr;
         return opts;
     }
 
@@ -145,8 +1793,490 @@ public:
 
     static auto DefaultReadOptions() -> leveldb::ReadOptions { return {}; }
 
+    // For large scans, keeps the scanned blocks from evicting the working set out of the block cache.
+    static auto BulkReadOptions() -> leveldb::ReadOptions {
+        leveldb::ReadOptions opts{};
+        opts.fill_cache = false;
+        return opts;
+    }
+
 private:
-    std::unique_ptr<leveldb::DB> handle_{};
+    auto WriteOptionsFor(const leveldb::WriteOptions& opts) const -> leveldb::WriteOptions {
+        if (!committer_) {
+            return opts;
+        }
+        leveldb::WriteOptions unsynced = opts;
+        unsynced.sync = false;
+        return unsynced;
+    }
+
+    void Written(const leveldb::Status& status, size_t bytes) {
+        if (committer_ && status.ok()) {
+            committer_->Record(bytes);
+        }
+    }
+
+    static constexpr size_t kMinKeysPerMultiGetThread = 64;
+
+    template <typename T>
+    void MultiGetSorted(std::span<const leveldb::Slice> keys,
+                        std::span<const size_t> order,
+                        std::vector<GetResult<T>>& results,
+                        const std::vector<uint64_t>& generations,
+                        const leveldb::ReadOptions& opts,
+                        bool use_cache) {
+        std::unique_ptr<leveldb::Iterator> it(handle_->NewIterator(opts));
+        bool positioned = false;
+
+        for (const size_t index : order) {
+            const leveldb::Slice& key = keys[index];
+            auto& result = results[index];
+
+            // Keys are sorted, the iterator only has to move when it is behind the current key.
+            if (!positioned || (it->Valid() && comparator_->Compare(it->key(), key) < 0)) {
+                it->Seek(key);
+                positioned = true;
+            }
+
+            if (!it->status().ok()) {
+                result.status = it->status();
+                continue;
+            }
+            if (!it->Valid() || comparator_->Compare(it->key(), key) != 0) {
+                result.status = leveldb::Status::NotFound(leveldb::Slice());
+                continue;
+            }
+
+            const leveldb::Slice value = it->value();
+            std::optional<T> parsed =
+                detail::Read<T, Codec>(std::string_view(value.data(), value.size()), CompressorFor<T>());
+            if (!parsed) {
+                result.status = leveldb::Status::IOError("Parse failed");
+                continue;
+            }
+
+            if (use_cache) {
+                auto shared = std::make_shared<const T>(std::move(parsed.value()));
+                result.value = *shared;
+                cache_->Insert(std::string_view(key.data(), key.size()), std::move(shared), value.size(),
+                               generations[index]);
+            } else {
+                result.value = std::move(parsed.value());
+            }
+        }
+    }
+
+    // Encodes into buffer and compresses the result if T has a dictionary.
+    template <typename T>
+    auto EncodeValue(const T& obj, std::string& buffer) const -> leveldb::Slice {
+        const leveldb::Slice value = detail::Encode<T, Codec>(obj, buffer);
+        if (const auto* compressor = CompressorFor<T>(); compressor) {
+            if (auto compressed = compressor->Compress(std::string_view(value.data(), value.size())); compressed) {
+                return leveldb::Slice(compressed->data(), compressed->size());
+            }
+        }
+        return value;
+    }
+
+    void StartAsync() {
+        async_ = std::make_unique<detail::AsyncWorkers>(
+            *async_opts_,
+            [this](leveldb::WriteBatch& batch, bool sync) {
+                leveldb::WriteOptions opts{};
+                opts.sync = sync;
+                const auto status = handle_->Write(WriteOptionsFor(opts), &batch);
+                Written(status, batch.ApproximateSize());
+                Invalidate(batch);
+                return status;
+            },
+            [this](std::vector<detail::PendingRead>& reads) { ReadCoalesced(reads); });
+    }
+
+    static auto AsyncNotEnabledStatus() -> leveldb::Status {
+        return leveldb::Status::InvalidArgument("Async operations are not enabled");
+    }
+
+    template <typename R>
+    static auto Ready(R value) -> std::future<R> {
+        std::promise<R> result;
+        result.set_value(std::move(value));
+        return result.get_future();
+    }
+
+    template <typename R>
+    static auto AsyncNotEnabled() -> std::future<R> {
+        if constexpr (std::is_same_v<R, leveldb::Status>)
+            return Ready(AsyncNotEnabledStatus());
+        else
+            return Ready(R{AsyncNotEnabledStatus()});
+    }
+
+    // Serves buffered writes, cache hits and remembered misses right away, everything else is read by the read
+    // coalescer and decoded on a worker.
+    template <typename T>
+    void StartGet(std::string key, const leveldb::ReadOptions& opts, std::function<void(GetResult<T>)> done) {
+        if (auto buffered = FindBufferedResult<T>(key, opts); buffered) {
+            done(std::move(*buffered));
+            return;
+        }
+        const bool use_cache = UseCache(opts);
+        uint64_t generation = 0;
+        if (use_cache) {
+            if (auto cached = cache_->Lookup<T>(key); cached) {
+                done(GetResult<T>{leveldb::Status::OK(), *cached});
+                return;
+            }
+            generation = cache_->Generation(key);
+        }
+        if (KnownMissing(key, opts)) {
+            done(GetResult<T>{leveldb::Status::NotFound(leveldb::Slice())});
+            return;
+        }
+
+        auto decode = [this, key, use_cache, generation, done = std::move(done)](const leveldb::Status& status,
+                                                                                std::string_view bytes) {
+            GetResult<T> result{status};
+            if (status.ok()) {
+                if (std::optional<T> parsed = detail::Read<T, Codec>(bytes, CompressorFor<T>()); !parsed) {
+                    result.status = leveldb::Status::IOError("Parse failed");
+                } else if (use_cache) {
+                    auto shared = std::make_shared<const T>(std::move(parsed.value()));
+                    result.value = *shared;
+                    cache_->Insert(key, std::move(shared), bytes.size(), generation);
+                } else {
+                    result.value = std::move(parsed.value());
+                }
+            }
+            done(std::move(result));
+        };
+        async_->reads.Get(detail::PendingRead{std::move(key), opts, std::move(decode)});
+    }
+
+    // Reads with equal options are sorted and share an iterator like MultiGet, single reads use a point lookup.
+    void ReadCoalesced(std::vector<detail::PendingRead>& reads) {
+        auto group = [](const leveldb::ReadOptions& opts) {
+            return std::make_tuple(reinterpret_cast<uintptr_t>(opts.snapshot), opts.fill_cache, opts.verify_checksums);
+        };
+        std::sort(reads.begin(), reads.end(), [&](const detail::PendingRead& lhs, const detail::PendingRead& rhs) {
+            if (group(lhs.opts) != group(rhs.opts)) {
+                return group(lhs.opts) < group(rhs.opts);
+            }
+            return comparator_->Compare(lhs.key, rhs.key) < 0;
+        });
+
+        for (size_t begin = 0, end = 0; begin < reads.size(); begin = end) {
+            for (end = begin + 1; end < reads.size() && group(reads[end].opts) == group(reads[begin].opts); ++end) {
+            }
+
+            if (end - begin == 1) {
+                std::string value;
+                const auto status = GetFromEngine(reads[begin].key, reads[begin].opts, value);
+                reads[begin].done(status, value);
+                continue;
+            }
+
+            std::unique_ptr<leveldb::Iterator> it(handle_->NewIterator(reads[begin].opts));
+            bool positioned = false;
+            for (size_t i = begin; i < end; ++i) {
+                const leveldb::Slice key(reads[i].key);
+                if (!positioned || (it->Valid() && comparator_->Compare(it->key(), key) < 0)) {
+                    it->Seek(key);
+                    positioned = true;
+                }
+
+                if (!it->status().ok()) {
+                    reads[i].done(it->status(), {});
+                } else if (!it->Valid() || comparator_->Compare(it->key(), key) != 0) {
+                    reads[i].done(leveldb::Status::NotFound(leveldb::Slice()), {});
+                } else {
+                    reads[i].done(leveldb::Status::OK(), std::string_view(it->value().data(), it->value().size()));
+                }
+            }
+        }
+    }
+
+    // Resuming inline would run the rest of the coroutine inside the drain that finished the operation, holding up
+    // the reads or writes queued behind it.
+    template <typename R>
+    auto ResumeOnWorkers(typename Awaitable<R>::Resume resume) -> typename Awaitable<R>::Resume {
+        return resume ? std::move(resume) : Awaitable<R>::ResumeOn(async_->pool);
+    }
+
+    template <typename T>
+    auto AwaitGet(const leveldb::Slice& key,
+                  typename Awaitable<GetResult<T>>::Resume resume,
+                  const leveldb::ReadOptions& opts) -> Awaitable<GetResult<T>> {
+        if (!async_) {
+            return Awaitable<GetResult<T>>(GetResult<T>{AsyncNotEnabledStatus()});
+        }
+        if (auto buffered = FindBufferedResult<T>(key, opts); buffered) {
+            return Awaitable<GetResult<T>>(std::move(*buffered));
+        }
+        if (UseCache(opts)) {
+            if (auto cached = cache_->Lookup<T>(std::string_view(key.data(), key.size())); cached) {
+                return Awaitable<GetResult<T>>(GetResult<T>{leveldb::Status::OK(), *cached});
+            }
+        }
+        return Awaitable<GetResult<T>>(
+            [this, key = key.ToString(), opts](auto done) mutable {
+                StartGet<T>(std::move(key), opts, std::move(done));
+            },
+            ResumeOnWorkers<GetResult<T>>(std::move(resume)));
+    }
+
+    // Encodes right away so obj does not have to outlive the awaitable.
+    template <typename T>
+    auto AwaitPut(const leveldb::Slice& key,
+                  const T& obj,
+                  Awaitable<leveldb::Status>::Resume resume,
+                  const leveldb::WriteOptions& opts) -> Awaitable<leveldb::Status> {
+        if (!async_) {
+            return Awaitable<leveldb::Status>(AsyncNotEnabledStatus());
+        }
+        if (write_behind_) {
+            return Awaitable<leveldb::Status>(Put(key, obj, opts));
+        }
+        detail::ScratchBuffer buffer{};
+        return Awaitable<leveldb::Status>(
+            [this, key = key.ToString(), value = EncodeValue(obj, buffer.get()).ToString(), sync = opts.sync](
+                auto done) { async_->writes.Put(key, value, sync, std::move(done)); },
+            ResumeOnWorkers<leveldb::Status>(std::move(resume)));
+    }
+
+    auto AwaitDelete(const leveldb::Slice& key,
+                     Awaitable<leveldb::Status>::Resume resume,
+                     const leveldb::WriteOptions& opts) -> Awaitable<leveldb::Status> {
+        if (!async_) {
+            return Awaitable<leveldb::Status>(AsyncNotEnabledStatus());
+        }
+        if (write_behind_) {
+            return Awaitable<leveldb::Status>(Delete(key, opts));
+        }
+        return Awaitable<leveldb::Status>(
+            [this, key = key.ToString(), sync = opts.sync](auto done) {
+                async_->writes.Delete(key, sync, std::move(done));
+            },
+            ResumeOnWorkers<leveldb::Status>(std::move(resume)));
+    }
+
+    template <typename T>
+    auto SharedCompressorFor() const -> std::shared_ptr<const detail::ValueCompressor> {
+        if (compressors_.empty()) {
+            return nullptr;
+        }
+        const auto found = compressors_.find(typeid(T));
+        return found == compressors_.end() ? nullptr : found->second;
+    }
+
+    template <typename T>
+    auto CompressorFor() const -> const detail::ValueCompressor* {
+        if (compressors_.empty()) {
+            return nullptr;
+        }
+        const auto found = compressors_.find(typeid(T));
+        return found == compressors_.end() ? nullptr : found->second.get();
+    }
+
+#ifdef ORYX_KVDB_ZSTD
+    // Loads all stored versions of the dictionary name on first use.
+    auto DictionaryFor(const std::string& name, const DictionaryOptions& opts)
+        -> std::pair<std::shared_ptr<detail::ZstdDictionaryCompressor>, leveldb::Status> {
+        auto& dictionary = dictionaries_[name];
+        if (dictionary) {
+            return {dictionary, leveldb::Status::OK()};
+        }
+
+        auto loaded = std::make_shared<detail::ZstdDictionaryCompressor>(opts.level, opts.max_value_bytes);
+        const std::string prefix = detail::DictionaryKeyPrefix(name);
+        std::unique_ptr<leveldb::Iterator> it(handle_->NewIterator(BulkReadOptions()));
+        for (it->Seek(prefix); it->Valid() && it->key().starts_with(prefix); it->Next()) {
+            const auto version =
+                detail::DictionaryVersion(std::string_view(it->key().data(), it->key().size()), prefix);
+            if (!version || !loaded->AddVersion(*version, std::string_view(it->value().data(), it->value().size()))) {
+                return {nullptr, leveldb::Status::Corruption(it->key(), "is not a valid dictionary")};
+            }
+        }
+        if (!it->status().ok()) {
+            return {nullptr, it->status()};
+        }
+
+        dictionary = loaded;
+        return {dictionary, leveldb::Status::OK()};
+    }
+#endif
+
+    auto PutEncoded(const leveldb::Slice& key, const leveldb::Slice& value, const leveldb::WriteOptions& opts)
+        -> leveldb::Status {
+        if (write_behind_) {
+            const auto status = write_behind_->Put(std::string_view(key.data(), key.size()),
+                                                   std::string_view(value.data(), value.size()), opts.sync);
+            Invalidate(key);
+            return status;
+        }
+        leveldb::Status status{};
+        if constexpr (std::same_as<Backend, LevelDbBackend>) {
+            detail::ScratchBatch batch{};
+            batch.get().Put(key, value);
+            status = handle_->Write(WriteOptionsFor(opts), &batch.get());
+        } else {
+            status = handle_->Put(WriteOptionsFor(opts), key, value);
+        }
+        Written(status, key.size() + value.size());
+        Invalidate(key);
+        return status;
+    }
+
+    // Called with the stripe lock of key held. Joins the batch of the async writers unless called on one of their
+    // workers, where waiting for the batch could wait on a drain queued behind the caller.
+    template <typename T>
+    auto WriteUpdated(const leveldb::Slice& key, T obj, const leveldb::WriteOptions& opts) -> leveldb::Status {
+        const std::string_view key_view(key.data(), key.size());
+        const uint64_t generation = cache_ ? cache_->Generation(key_view) : 0;
+
+        detail::ScratchBuffer buffer{};
+        const leveldb::Slice value = EncodeValue(obj, buffer.get());
+        const auto status = async_ && !write_behind_ && !async_->pool.OnWorker()
+                                ? async_->writes.Put(key_view, std::string_view(value.data(), value.size()), opts.sync)
+                                      .get()
+                                : PutEncoded(key, value, opts);
+
+        // The write erased key once, any further erase in the cache shard meanwhile may have been a newer write of
+        // key through Put, so the object is only cached if there was none.
+        if (status.ok() && cache_ && cache_->Generation(key_view) == generation + 1) {
+            cache_->Insert(key_view, std::make_shared<const T>(std::move(obj)), value.size(), generation + 1);
+        }
+        return status;
+    }
+
+    void StartWriteBehind() {
+        write_behind_ = std::make_unique<detail::WriteBehindBuffer>(
+            *write_behind_opts_, [this](leveldb::WriteBatch& batch, bool sync) {
+                leveldb::WriteOptions opts{};
+                opts.sync = sync;
+                const auto status = handle_->Write(WriteOptionsFor(opts), &batch);
+                Written(status, batch.ApproximateSize());
+                Invalidate(batch);
+                return status;
+            });
+    }
+
+    // Buffered writes are newer than any snapshot, so snapshot reads only see the engine state.
+    auto FindBuffered(const leveldb::Slice& key, const leveldb::ReadOptions& opts, std::string& value) const
+        -> std::optional<leveldb::Status> {
+        if (!write_behind_ || opts.snapshot != nullptr) {
+            return std::nullopt;
+        }
+        return write_behind_->Find(std::string_view(key.data(), key.size()), value);
+    }
+
+    template <typename T>
+    auto FindBufferedResult(const leveldb::Slice& key, const leveldb::ReadOptions& opts) const
+        -> std::optional<GetResult<T>> {
+        std::string value;
+        auto buffered = FindBuffered(key, opts, value);
+        if (!buffered) {
+            return std::nullopt;
+        }
+        GetResult<T> result{*buffered};
+        if (result.status.ok()) {
+            if (std::optional<T> parsed = detail::Read<T, Codec>(value, CompressorFor<T>()); parsed) {
+                result.value = std::move(parsed.value());
+            } else {
+                result.status = leveldb::Status::IOError("Parse failed");
+            }
+        }
+        return result;
+    }
+
+    // Snapshot reads must see the engine state, so they bypass the cache.
+    auto UseCache(const leveldb::ReadOptions& opts) const -> bool { return cache_ && opts.snapshot == nullptr; }
+
+    // A key missing now may have existed at the snapshot, so snapshot reads bypass the negative cache too.
+    auto UseNegativeCache(const leveldb::ReadOptions& opts) const -> bool {
+        return negative_ && opts.snapshot == nullptr;
+    }
+
+    auto KnownMissing(const leveldb::Slice& key, const leveldb::ReadOptions& opts) const -> bool {
+        return UseNegativeCache(opts) && negative_->Contains(std::string_view(key.data(), key.size()));
+    }
+
+    // Answers keys in the negative cache with NotFound, otherwise runs read and remembers the key if it missed.
+    template <typename Read>
+    auto ReadThroughNegativeCache(const leveldb::Slice& key, const leveldb::ReadOptions& opts, Read&& read)
+        -> leveldb::Status {
+        if (!UseNegativeCache(opts)) {
+            return read();
+        }
+        const std::string_view key_view(key.data(), key.size());
+        if (negative_->Contains(key_view)) {
+            return leveldb::Status::NotFound(leveldb::Slice());
+        }
+        const uint64_t generation = negative_->Generation(key_view);
+        leveldb::Status status = read();
+        if (status.IsNotFound()) {
+            negative_->Insert(key_view, generation);
+        }
+        return status;
+    }
+
+    auto GetFromEngine(const leveldb::Slice& key, const leveldb::ReadOptions& opts, std::string& value)
+        -> leveldb::Status {
+        return ReadThroughNegativeCache(key, opts, [&] { return handle_->Get(opts, key, &value); });
+    }
+
+    // Runs after the engine write, a reader that missed before it can then no longer insert the old value.
+    void Invalidate(const leveldb::Slice& key) {
+        const std::string_view key_view(key.data(), key.size());
+        if (cache_) {
+            cache_->Erase(key_view);
+        }
+        if (negative_) {
+            negative_->Erase(key_view);
+        }
+    }
+
+    void Invalidate(const leveldb::WriteBatch& batch) {
+        if (!cache_ && !negative_) {
+            return;
+        }
+
+        struct Handler : leveldb::WriteBatch::Handler {
+            explicit Handler(BasicKeyValueDatabase& db)
+                : db(db) {}
+
+            void Put(const leveldb::Slice& key, const leveldb::Slice&) override { Delete(key); }
+            void Delete(const leveldb::Slice& key) override { db.Invalidate(key); }
+
+            BasicKeyValueDatabase& db;
+        } handler(*this);
+        batch.Iterate(&handler);
+    }
+
+    ResourceManager* resources_{nullptr};
+    // Returned after the database is closed.
+    std::unique_ptr<ResourceManager::Lease> lease_{};
+    std::unique_ptr<Backend> handle_{};
+    const leveldb::Comparator* comparator_{leveldb::BytewiseComparator()};
+    Durability durability_{Durability::kSync};
+    GroupCommitOptions group_commit_opts_{};
+    std::unique_ptr<detail::GroupCommitter> committer_{};
+    std::unique_ptr<ObjectCache> cache_{};
+    std::unique_ptr<NegativeCache> negative_{};
+    std::unordered_map<std::type_index, std::shared_ptr<const detail::ValueCompressor>> compressors_{};
+#ifdef ORYX_KVDB_ZSTD
+    std::unordered_map<std::string, std::shared_ptr<detail::ZstdDictionaryCompressor>> dictionaries_{};
+#endif
+    [[no_unique_address]] detail::MetricsRecorder<> metrics_{};
+    std::unique_ptr<detail::LockStripes> update_locks_{std::make_unique<detail::LockStripes>()};
+    std::optional<WriteBehindOptions> write_behind_opts_{};
+    // Flushes through the members above when destroyed.
+    std::unique_ptr<detail::WriteBehindBuffer> write_behind_{};
+    std::optional<AsyncOptions> async_opts_{};
+    // Last so pending async operations finish before the members they use are destroyed.
+    std::unique_ptr<detail::AsyncWorkers> async_{};
 };
 
+using KeyValueDatabase = BasicKeyValueDatabase<>;
+using MemoryKeyValueDatabase = BasicKeyValueDatabase<JsonCodec, MemoryBackend>;
+
 }  // namespace oryx
\ No newline at end of file
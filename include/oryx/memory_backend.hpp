@@ -0,0 +1,317 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <leveldb/comparator.h>
+#include <leveldb/db.h>
+#include <leveldb/iterator.h>
+#include <leveldb/options.h>
+#include <leveldb/write_batch.h>
+
+#include <oryx/backend.hpp>
+
+namespace oryx {
+
+// Ordered in memory engine for caches and tests, nothing touches the disk. Open starts empty whatever the name,
+// and the data is gone once the database is closed. Keys are hashed onto kStripes ordered maps with a lock each,
+// so operations on different stripes do not contend.
+// Write batches are applied atomically. Snapshots are not supported: GetSnapshot returns nullptr and reads see the
+// latest data. Iterators copy the stripes in batches and merge them, so a scan may see writes made while it runs.
+class MemoryBackend {
+public:
+    static constexpr size_t kStripes = 16;
+    // Open ignores the name, nothing is created on disk.
+    static constexpr bool kInMemory = true;
+
+    explicit MemoryBackend(const leveldb::Comparator* comparator = leveldb::BytewiseComparator()) {
+        for (auto& stripe : stripes_) {
+            stripe.entries = Entries(KeyLess{comparator});
+        }
+    }
+
+    static auto Open(const leveldb::Options& opts, const std::string&, std::unique_ptr<MemoryBackend>& opened)
+        -> leveldb::Status {
+        opened = std::make_unique<MemoryBackend>(opts.comparator);
+        return leveldb::Status::OK();
+    }
+
+    auto Put(const leveldb::WriteOptions&, const leveldb::Slice& key, const leveldb::Slice& value)
+        -> leveldb::Status {
+        auto& stripe = StripeFor(key);
+        std::lock_guard lock(stripe.mutex);
+        Assign(stripe, key, value);
+        return leveldb::Status::OK();
+    }
+
+    auto Delete(const leveldb::WriteOptions&, const leveldb::Slice& key) -> leveldb::Status {
+        auto& stripe = StripeFor(key);
+        std::lock_guard lock(stripe.mutex);
+        Erase(stripe, key);
+        return leveldb::Status::OK();
+    }
+
+    // Locks every stripe the batch touches in index order, readers see all of its updates or none.
+    auto Write(const leveldb::WriteOptions&, leveldb::WriteBatch* batch) -> leveldb::Status {
+        if (batch == nullptr) {
+            return leveldb::Status::OK();
+        }
+
+        struct Touched : leveldb::WriteBatch::Handler {
+            explicit Touched(const MemoryBackend& backend)
+                : backend(backend) {}
+
+            void Put(const leveldb::Slice& key, const leveldb::Slice&) override { Delete(key); }
+            void Delete(const leveldb::Slice& key) override { stripes.set(backend.StripeIndex(key)); }
+
+            const MemoryBackend& backend;
+            std::bitset<kStripes> stripes{};
+        } touched(*this);
+        if (auto status = batch->Iterate(&touched); !status.ok()) {
+            return status;
+        }
+
+        std::array<std::unique_lock<std::shared_mutex>, kStripes> locks{};
+        for (size_t i = 0; i < kStripes; ++i) {
+            if (touched.stripes.test(i)) {
+                locks[i] = std::unique_lock(stripes_[i].mutex);
+            }
+        }
+
+        struct Apply : leveldb::WriteBatch::Handler {
+            explicit Apply(MemoryBackend& backend)
+                : backend(backend) {}
+
+            void Put(const leveldb::Slice& key, const leveldb::Slice& value) override {
+                Assign(backend.StripeFor(key), key, value);
+            }
+            void Delete(const leveldb::Slice& key) override { Erase(backend.StripeFor(key), key); }
+
+            MemoryBackend& backend;
+        } apply(*this);
+        return batch->Iterate(&apply);
+    }
+
+    auto Get(const leveldb::ReadOptions&, const leveldb::Slice& key, std::string* value) -> leveldb::Status {
+        auto& stripe = StripeFor(key);
+        std::shared_lock lock(stripe.mutex);
+        const auto found = stripe.entries.find(key);
+        if (found == stripe.entries.end()) {
+            return leveldb::Status::NotFound(leveldb::Slice());
+        }
+        value->assign(found->second);
+        return leveldb::Status::OK();
+    }
+
+    // Must be deleted before the backend.
+    auto NewIterator(const leveldb::ReadOptions&) -> leveldb::Iterator* { return new Iterator(*this); }
+
+    static auto GetSnapshot() -> const leveldb::Snapshot* { return nullptr; }
+    static void ReleaseSnapshot(const leveldb::Snapshot*) {}
+
+    // Answers leveldb.approximate-memory-usage with the bytes of the stored keys and values.
+    auto GetProperty(const leveldb::Slice& property, std::string* value) -> bool {
+        if (property != leveldb::Slice("leveldb.approximate-memory-usage")) {
+            return false;
+        }
+        size_t bytes = 0;
+        for (auto& stripe : stripes_) {
+            std::shared_lock lock(stripe.mutex);
+            bytes += stripe.bytes;
+        }
+        *value = std::to_string(bytes);
+        return true;
+    }
+
+private:
+    // Slice converts from std::string, which makes lookups by Slice transparent.
+    struct KeyLess {
+        using is_transparent = void;
+
+        auto operator()(const leveldb::Slice& lhs, const leveldb::Slice& rhs) const -> bool {
+            return comparator->Compare(lhs, rhs) < 0;
+        }
+
+        const leveldb::Comparator* comparator{leveldb::BytewiseComparator()};
+    };
+
+    using Entries = std::map<std::string, std::string, KeyLess>;
+
+    struct alignas(64) Stripe {
+        mutable std::shared_mutex mutex{};
+        Entries entries{};
+        size_t bytes{0};
+    };
+
+    // Copies the entries of every stripe in batches of kBatchEntries and merges the stripes, so a scan takes each
+    // stripe lock once per kBatchEntries entries of that stripe instead of on every step, and every step compares
+    // the heads of the kStripes batches. Seeks and changes of direction copy a new batch from every stripe. The
+    // batches are not a snapshot, writes made while the scan runs are seen once their stripe is copied again.
+    class Iterator : public leveldb::Iterator {
+    public:
+        explicit Iterator(MemoryBackend& backend)
+            : backend_(backend),
+              less_(backend.stripes_.front().entries.key_comp()) {}
+
+        [[nodiscard]] auto Valid() const -> bool override { return current_ < kStripes; }
+
+        void SeekToFirst() override { SeekAll(true, nullptr, true); }
+        void SeekToLast() override { SeekAll(false, nullptr, true); }
+
+        // target may point into this iterator, so it is copied before the batches are replaced.
+        void Seek(const leveldb::Slice& target) override {
+            const std::string bound = target.ToString();
+            SeekAll(true, &bound, true);
+        }
+
+        void Next() override {
+            if (!forward_) {
+                const std::string bound = Head(current_).first;
+                SeekAll(true, &bound, false);
+                return;
+            }
+            Advance(current_);
+            Pick();
+        }
+
+        void Prev() override {
+            if (forward_) {
+                const std::string bound = Head(current_).first;
+                SeekAll(false, &bound, false);
+                return;
+            }
+            Advance(current_);
+            Pick();
+        }
+
+        [[nodiscard]] auto key() const -> leveldb::Slice override { return Head(current_).first; }
+        [[nodiscard]] auto value() const -> leveldb::Slice override { return Head(current_).second; }
+        [[nodiscard]] auto status() const -> leveldb::Status override { return leveldb::Status::OK(); }
+
+    private:
+        static constexpr size_t kBatchEntries = 64;
+
+        using Entry = std::pair<std::string, std::string>;
+
+        // Entries of one stripe in the direction of the iterator.
+        struct Cursor {
+            std::vector<Entry> entries{};
+            size_t pos{0};
+            // Whether the stripe has entries beyond the batch.
+            bool more{false};
+        };
+
+        [[nodiscard]] auto Head(size_t stripe) const -> const Entry& {
+            return cursors_[stripe].entries[cursors_[stripe].pos];
+        }
+
+        void SeekAll(bool forward, const std::string* bound, bool inclusive) {
+            forward_ = forward;
+            for (size_t i = 0; i < kStripes; ++i) {
+                Fill(i, bound, inclusive);
+            }
+            Pick();
+        }
+
+        // Copies the next batch of stripe i from bound on, or from its first or last entry without a bound.
+        void Fill(size_t i, const std::string* bound, bool inclusive) {
+            auto& cursor = cursors_[i];
+            cursor.entries.clear();
+            cursor.pos = 0;
+
+            const auto& stripe = backend_.stripes_[i];
+            std::shared_lock lock(stripe.mutex);
+            const Entries& entries = stripe.entries;
+            if (forward_) {
+                auto it = bound == nullptr ? entries.begin()
+                          : inclusive      ? entries.lower_bound(*bound)
+                                           : entries.upper_bound(*bound);
+                for (; it != entries.end() && cursor.entries.size() < kBatchEntries; ++it) {
+                    cursor.entries.emplace_back(it->first, it->second);
+                }
+                cursor.more = it != entries.end();
+            } else {
+                auto it = bound == nullptr ? entries.end()
+                          : inclusive      ? entries.upper_bound(*bound)
+                                           : entries.lower_bound(*bound);
+                while (it != entries.begin() && cursor.entries.size() < kBatchEntries) {
+                    --it;
+                    cursor.entries.emplace_back(it->first, it->second);
+                }
+                cursor.more = it != entries.begin();
+            }
+        }
+
+        void Advance(size_t i) {
+            auto& cursor = cursors_[i];
+            if (++cursor.pos < cursor.entries.size() || !cursor.more) {
+                return;
+            }
+            const std::string last = std::move(cursor.entries.back().first);
+            Fill(i, &last, false);
+        }
+
+        // Moves to the smallest, or backwards the largest, head of the stripes.
+        void Pick() {
+            current_ = kStripes;
+            for (size_t i = 0; i < kStripes; ++i) {
+                if (cursors_[i].pos >= cursors_[i].entries.size()) {
+                    continue;
+                }
+                if (current_ == kStripes || (forward_ ? less_(Head(i).first, Head(current_).first)
+                                                      : less_(Head(current_).first, Head(i).first))) {
+                    current_ = i;
+                }
+            }
+        }
+
+        MemoryBackend& backend_;
+        KeyLess less_;
+        bool forward_{true};
+        std::array<Cursor, kStripes> cursors_{};
+        // kStripes if not valid.
+        size_t current_{kStripes};
+    };
+
+    static void Assign(Stripe& stripe, const leveldb::Slice& key, const leveldb::Slice& value) {
+        auto found = stripe.entries.find(key);
+        if (found == stripe.entries.end()) {
+            found = stripe.entries.emplace(key.ToString(), std::string()).first;
+            stripe.bytes += key.size();
+        } else {
+            stripe.bytes -= found->second.size();
+        }
+        found->second.assign(value.data(), value.size());
+        stripe.bytes += value.size();
+    }
+
+    static void Erase(Stripe& stripe, const leveldb::Slice& key) {
+        if (const auto found = stripe.entries.find(key); found != stripe.entries.end()) {
+            stripe.bytes -= found->first.size() + found->second.size();
+            stripe.entries.erase(found);
+        }
+    }
+
+    [[nodiscard]] auto StripeIndex(const leveldb::Slice& key) const -> size_t {
+        return std::hash<std::string_view>{}(std::string_view(key.data(), key.size())) % kStripes;
+    }
+
+    auto StripeFor(const leveldb::Slice& key) -> Stripe& { return stripes_[StripeIndex(key)]; }
+
+    std::array<Stripe, kStripes> stripes_{};
+};
+
+static_assert(StorageBackend<MemoryBackend>);
+
+}  // namespace oryx
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+namespace oryx {
+
+// Log linear latency histogram in nanoseconds like HdrHistogram: every power of two is split into
+// kSubBuckets linear buckets, so a bucket is at most 1 / kSubBuckets wider than its lower bound.
+class LatencyHistogram {
+public:
+    static constexpr size_t kSubBucketBits = 3;
+    static constexpr size_t kSubBuckets = size_t{1} << kSubBucketBits;
+    // Latencies from 2^kMaxExponent ns, about 68 s, on are counted in the last bucket.
+    static constexpr size_t kMaxExponent = 36;
+    static constexpr size_t kBucketCount = (kMaxExponent - kSubBucketBits + 1) * kSubBuckets;
+
+    static constexpr auto BucketFor(uint64_t nanos) -> size_t {
+        if (nanos < kSubBuckets) {
+            return static_cast<size_t>(nanos);
+        }
+        const size_t exponent = static_cast<size_t>(std::bit_width(nanos)) - 1;
+        if (exponent >= kMaxExponent) {
+            return kBucketCount - 1;
+        }
+        const size_t sub_bucket = static_cast<size_t>(nanos >> (exponent - kSubBucketBits)) & (kSubBuckets - 1);
+        return (exponent - kSubBucketBits + 1) * kSubBuckets + sub_bucket;
+    }
+
+    static constexpr auto LowerBound(size_t bucket) -> uint64_t {
+        if (bucket < kSubBuckets) {
+            return bucket;
+        }
+        const size_t exponent = bucket / kSubBuckets + kSubBucketBits - 1;
+        return (uint64_t{1} << exponent) + (uint64_t{bucket % kSubBuckets} << (exponent - kSubBucketBits));
+    }
+
+    LatencyHistogram() = default;
+
+    // Counts per bucket and their exact sum, which bucket lower bounds would understate.
+    LatencyHistogram(const std::array<uint64_t, kBucketCount>& buckets, uint64_t total_nanos)
+        : buckets_(buckets),
+          total_nanos_(total_nanos) {
+        for (const uint64_t count : buckets_) {
+            count_ += count;
+        }
+    }
+
+    void Record(uint64_t nanos, uint64_t count = 1) {
+        buckets_[BucketFor(nanos)] += count;
+        count_ += count;
+        total_nanos_ += nanos * count;
+    }
+
+    void Merge(const LatencyHistogram& other) {
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            buckets_[i] += other.buckets_[i];
+        }
+        count_ += other.count_;
+        total_nanos_ += other.total_nanos_;
+    }
+
+    // Lower bound of the bucket holding the quantile q in [0, 1], 0 without samples.
+    [[nodiscard]] auto Percentile(double q) const -> std::chrono::nanoseconds {
+        if (count_ == 0) {
+            return {};
+        }
+        const auto rank = static_cast<uint64_t>(q * static_cast<double>(count_ - 1));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBucketCount; ++i) {
+            seen += buckets_[i];
+            if (seen > rank) {
+                return std::chrono::nanoseconds(LowerBound(i));
+            }
+        }
+        return std::chrono::nanoseconds(LowerBound(kBucketCount - 1));
+    }
+
+    [[nodiscard]] auto Mean() const -> std::chrono::nanoseconds {
+        return std::chrono::nanoseconds(count_ == 0 ? 0 : total_nanos_ / count_);
+    }
+
+    [[nodiscard]] auto count() const -> uint64_t { return count_; }
+    [[nodiscard]] auto total() const -> std::chrono::nanoseconds { return std::chrono::nanoseconds(total_nanos_); }
+    [[nodiscard]] auto buckets() const -> const std::array<uint64_t, kBucketCount>& { return buckets_; }
+
+private:
+    std::array<uint64_t, kBucketCount> buckets_{};
+    uint64_t count_{0};
+    uint64_t total_nanos_{0};
+};
+
+struct OperationMetrics {
+    // Calls, including object cache hits which do not record latencies.
+    uint64_t count{0};
+    // Key and stored value bytes.
+    uint64_t bytes{0};
+    // Time spent in leveldb or the write behind buffer.
+    LatencyHistogram engine{};
+    // Time spent encoding or decoding, including compression.
+    LatencyHistogram codec{};
+
+    void Merge(const OperationMetrics& other) {
+        count += other.count;
+        bytes += other.bytes;
+        engine.Merge(other.engine);
+        codec.Merge(other.codec);
+    }
+};
+
+struct DatabaseMetrics {
+    OperationMetrics get{};
+    OperationMetrics put{};
+    OperationMetrics del{};
+    uint64_t cache_hits{0};
+    uint64_t parse_failures{0};
+
+    void Merge(const DatabaseMetrics& other) {
+        get.Merge(other.get);
+        put.Merge(other.put);
+        del.Merge(other.del);
+        cache_hits += other.cache_hits;
+        parse_failures += other.parse_failures;
+    }
+};
+
+namespace detail {
+
+#ifdef ORYX_KVDB_METRICS
+inline constexpr bool kMetricsEnabled = true;
+#else
+inline constexpr bool kMetricsEnabled = false;
+#endif
+
+template <bool kEnabled = kMetricsEnabled>
+class Stopwatch {
+public:
+    // Nanoseconds since construction or the previous lap.
+    auto Lap() -> uint64_t {
+        const auto now = std::chrono::steady_clock::now();
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start_).count();
+        start_ = now;
+        return static_cast<uint64_t>(elapsed);
+    }
+
+private:
+    std::chrono::steady_clock::time_point start_{std::chrono::steady_clock::now()};
+};
+
+template <>
+class Stopwatch<false> {
+public:
+    static constexpr auto Lap() -> uint64_t { return 0; }
+};
+
+enum class Operation : uint8_t { kGet, kPut, kDelete };
+
+template <bool kEnabled = kMetricsEnabled>
+class MetricsRecorder {
+public:
+    // Without codec_nanos nothing was encoded or decoded, such as for deletes and missing keys.
+    void Record(Operation op, size_t bytes, uint64_t engine_nanos, std::optional<uint64_t> codec_nanos = {}) {
+        auto& metrics = LocalStripe().operations[static_cast<size_t>(op)];
+        Add(metrics.count, 1);
+        Add(metrics.bytes, bytes);
+        metrics.engine.Record(engine_nanos);
+        if (codec_nanos) {
+            metrics.codec.Record(*codec_nanos);
+        }
+    }
+
+    void RecordCacheHit() {
+        auto& stripe = LocalStripe();
+        Add(stripe.operations[static_cast<size_t>(Operation::kGet)].count, 1);
+        Add(stripe.cache_hits, 1);
+    }
+
+    void RecordParseFailure() { Add(LocalStripe().parse_failures, 1); }
+
+    // Merges the stripes, concurrent operations may be partially included.
+    [[nodiscard]] auto Snapshot() const -> DatabaseMetrics {
+        DatabaseMetrics result{};
+        for (const auto& stripe : *stripes_) {
+            Merge(stripe.operations[static_cast<size_t>(Operation::kGet)], result.get);
+            Merge(stripe.operations[static_cast<size_t>(Operation::kPut)], result.put);
+            Merge(stripe.operations[static_cast<size_t>(Operation::kDelete)], result.del);
+            result.cache_hits += stripe.cache_hits.load(std::memory_order_relaxed);
+            result.parse_failures += stripe.parse_failures.load(std::memory_order_relaxed);
+        }
+        return result;
+    }
+
+private:
+    class AtomicHistogram {
+    public:
+        void Record(uint64_t nanos) {
+            Add(buckets_[LatencyHistogram::BucketFor(nanos)], 1);
+            Add(total_nanos_, nanos);
+        }
+
+        [[nodiscard]] auto Load() const -> LatencyHistogram {
+            std::array<uint64_t, LatencyHistogram::kBucketCount> buckets{};
+            for (size_t i = 0; i < buckets.size(); ++i) {
+                buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+            }
+            return LatencyHistogram(buckets, total_nanos_.load(std::memory_order_relaxed));
+        }
+
+    private:
+        std::array<std::atomic<uint64_t>, LatencyHistogram::kBucketCount> buckets_{};
+        std::atomic<uint64_t> total_nanos_{0};
+    };
+
+    struct Operations {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> bytes{0};
+        AtomicHistogram engine{};
+        AtomicHistogram codec{};
+    };
+
+    // Threads are assigned stripes round robin, so with up to kStripes threads each one updates its own
+    // counters and the relaxed increments never contend.
+    struct alignas(64) Stripe {
+        std::array<Operations, 3> operations{};
+        std::atomic<uint64_t> cache_hits{0};
+        std::atomic<uint64_t> parse_failures{0};
+    };
+
+    static constexpr size_t kStripes = 8;
+
+    static void Add(std::atomic<uint64_t>& counter, uint64_t value) {
+        counter.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    static void Merge(const Operations& from, OperationMetrics& to) {
+        to.Merge(OperationMetrics{from.count.load(std::memory_order_relaxed),
+                                  from.bytes.load(std::memory_order_relaxed), from.engine.Load(), from.codec.Load()});
+    }
+
+    auto LocalStripe() -> Stripe& {
+        static std::atomic<size_t> next{0};
+        thread_local const size_t index = next.fetch_add(1, std::memory_order_relaxed) % kStripes;
+        return (*stripes_)[index];
+    }
+
+    std::unique_ptr<std::array<Stripe, kStripes>> stripes_{std::make_unique<std::array<Stripe, kStripes>>()};
+};
+
+// Compiles to nothing without ORYX_KVDB_METRICS.
+template <>
+class MetricsRecorder<false> {
+public:
+    static void Record(Operation, size_t, uint64_t, std::optional<uint64_t> = {}) {}
+    static void RecordCacheHit() {}
+    static void RecordParseFailure() {}
+    [[nodiscard]] static auto Snapshot() -> DatabaseMetrics { return {}; }
+};
+
+}  // namespace detail
+}  // namespace oryx
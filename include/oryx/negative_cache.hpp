@@ -0,0 +1,126 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace oryx {
+
+struct NegativeCacheOptions {
+    // Number of independently locked shards.
+    size_t shard_count = 16;
+    // Budget over all shards, the least recently missed keys are evicted first.
+    size_t max_keys = 64 * 1024;
+};
+
+// Sharded LRU set of keys that were recently found missing.
+class NegativeCache {
+public:
+    explicit NegativeCache(const NegativeCacheOptions& opts = {})
+        : shards_(opts.shard_count == 0 ? 1 : opts.shard_count) {
+        for (auto& shard : shards_) {
+            shard.max_keys = std::max<size_t>(1, opts.max_keys / shards_.size());
+        }
+    }
+
+    auto Contains(std::string_view key) -> bool { return ShardFor(key).Contains(key); }
+
+    // Returns the generation of key which has to be passed to Insert, read it before looking key up.
+    auto Generation(std::string_view key) -> uint64_t { return ShardFor(key).Generation(); }
+
+    // Skips the insert if key was erased after generation was taken, so a key written meanwhile is not hidden.
+    void Insert(std::string_view key, uint64_t generation) { ShardFor(key).Insert(key, generation); }
+
+    void Erase(std::string_view key) { ShardFor(key).Erase(key); }
+
+    void Clear() {
+        for (auto& shard : shards_) {
+            shard.Clear();
+        }
+    }
+
+    [[nodiscard]] auto size() -> size_t {
+        size_t total = 0;
+        for (auto& shard : shards_) {
+            std::lock_guard lock(shard.mutex);
+            total += shard.lru.size();
+        }
+        return total;
+    }
+
+private:
+    using KeyList = std::list<std::string>;
+
+    struct Shard {
+        std::mutex mutex{};
+        KeyList lru{};
+        // Views into the keys owned by lru.
+        std::unordered_map<std::string_view, KeyList::iterator> index{};
+        uint64_t generation{0};
+        size_t max_keys{0};
+
+        auto Contains(std::string_view key) -> bool {
+            std::lock_guard lock(mutex);
+            auto found = index.find(key);
+            if (found == index.end()) {
+                return false;
+            }
+            lru.splice(lru.begin(), lru, found->second);
+            return true;
+        }
+
+        auto Generation() -> uint64_t {
+            std::lock_guard lock(mutex);
+            return generation;
+        }
+
+        void Insert(std::string_view key, uint64_t expected_generation) {
+            std::lock_guard lock(mutex);
+            if (generation != expected_generation) {
+                return;
+            }
+            if (auto found = index.find(key); found != index.end()) {
+                lru.splice(lru.begin(), lru, found->second);
+                return;
+            }
+
+            lru.emplace_front(key);
+            index.emplace(lru.front(), lru.begin());
+            while (lru.size() > max_keys) {
+                index.erase(lru.back());
+                lru.pop_back();
+            }
+        }
+
+        void Erase(std::string_view key) {
+            std::lock_guard lock(mutex);
+            ++generation;
+            if (auto found = index.find(key); found != index.end()) {
+                const auto entry = found->second;
+                index.erase(found);
+                lru.erase(entry);
+            }
+        }
+
+        void Clear() {
+            std::lock_guard lock(mutex);
+            ++generation;
+            index.clear();
+            lru.clear();
+        }
+    };
+
+    auto ShardFor(std::string_view key) -> Shard& {
+        return shards_[std::hash<std::string_view>{}(key) % shards_.size()];
+    }
+
+    std::vector<Shard> shards_;
+};
+
+}  // namespace oryx
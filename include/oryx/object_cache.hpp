@@ -0,0 +1,195 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+namespace oryx {
+
+struct ObjectCacheOptions {
+    // Number of independently locked shards.
+    size_t shard_count = 16;
+    // Budget over all shards, charged with the stored value size plus the key size of each entry.
+    size_t capacity_bytes = 32 * 1024 * 1024;
+    // Optional budget over all shards, 0 means unlimited.
+    size_t max_entries = 0;
+};
+
+// Sharded LRU cache of deserialized objects keyed by (key, type).
+class ObjectCache {
+public:
+    explicit ObjectCache(const ObjectCacheOptions& opts = {})
+        : shards_(opts.shard_count == 0 ? 1 : opts.shard_count) {
+        for (auto& shard : shards_) {
+            shard.capacity_bytes = opts.capacity_bytes / shards_.size();
+            shard.max_entries = opts.max_entries == 0 ? 0 : std::max<size_t>(1, opts.max_entries / shards_.size());
+        }
+    }
+
+    template <typename T>
+    auto Lookup(std::string_view key) -> std::shared_ptr<const T> {
+        return std::static_pointer_cast<const T>(ShardFor(key).Lookup(key, typeid(T)));
+    }
+
+    // Returns the generation of key which has to be passed to Insert, read it before reading the value.
+    auto Generation(std::string_view key) -> uint64_t { return ShardFor(key).Generation(); }
+
+    // Skips the insert if key was erased after generation was taken so stale values are never cached.
+    template <typename T>
+    void Insert(std::string_view key, std::shared_ptr<const T> value, size_t charge, uint64_t generation) {
+        ShardFor(key).Insert(key, typeid(T), std::move(value), charge + key.size(), generation);
+    }
+
+    // Erases key for all types.
+    void Erase(std::string_view key) { ShardFor(key).Erase(key); }
+
+    void Clear() {
+        for (auto& shard : shards_) {
+            shard.Clear();
+        }
+    }
+
+    [[nodiscard]] auto size() -> size_t {
+        size_t total = 0;
+        for (auto& shard : shards_) {
+            std::lock_guard lock(shard.mutex);
+            total += shard.lru.size();
+        }
+        return total;
+    }
+
+    [[nodiscard]] auto charge() -> size_t {
+        size_t total = 0;
+        for (auto& shard : shards_) {
+            std::lock_guard lock(shard.mutex);
+            total += shard.charge;
+        }
+        return total;
+    }
+
+private:
+    struct Entry {
+        std::string key;
+        std::type_index type;
+        std::shared_ptr<const void> value;
+        size_t charge;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    struct StringHash {
+        using is_transparent = void;
+        auto operator()(std::string_view s) const -> size_t { return std::hash<std::string_view>{}(s); }
+    };
+
+    struct Shard {
+        std::mutex mutex{};
+        EntryList lru{};
+        std::unordered_map<std::string, std::vector<EntryList::iterator>, StringHash, std::equal_to<>> index{};
+        uint64_t generation{0};
+        size_t charge{0};
+        size_t capacity_bytes{0};
+        size_t max_entries{0};
+
+        auto Lookup(std::string_view key, std::type_index type) -> std::shared_ptr<const void> {
+            std::lock_guard lock(mutex);
+            auto found = index.find(key);
+            if (found == index.end()) {
+                return nullptr;
+            }
+            for (auto entry : found->second) {
+                if (entry->type == type) {
+                    lru.splice(lru.begin(), lru, entry);
+                    return entry->value;
+                }
+            }
+            return nullptr;
+        }
+
+        auto Generation() -> uint64_t {
+            std::lock_guard lock(mutex);
+            return generation;
+        }
+
+        void Insert(std::string_view key,
+                    std::type_index type,
+                    std::shared_ptr<const void> value,
+                    size_t entry_charge,
+                    uint64_t expected_generation) {
+            std::lock_guard lock(mutex);
+            if (generation != expected_generation || entry_charge > capacity_bytes) {
+                return;
+            }
+
+            auto found = index.find(key);
+            if (found == index.end()) {
+                found = index.emplace(std::string(key), std::vector<EntryList::iterator>{}).first;
+            }
+            for (auto entry : found->second) {
+                if (entry->type == type) {
+                    charge = charge - entry->charge + entry_charge;
+                    entry->value = std::move(value);
+                    entry->charge = entry_charge;
+                    lru.splice(lru.begin(), lru, entry);
+                    Evict();
+                    return;
+                }
+            }
+
+            lru.push_front(Entry{found->first, type, std::move(value), entry_charge});
+            found->second.push_back(lru.begin());
+            charge += entry_charge;
+            Evict();
+        }
+
+        void Erase(std::string_view key) {
+            std::lock_guard lock(mutex);
+            ++generation;
+            auto found = index.find(key);
+            if (found == index.end()) {
+                return;
+            }
+            for (auto entry : found->second) {
+                charge -= entry->charge;
+                lru.erase(entry);
+            }
+            index.erase(found);
+        }
+
+        void Clear() {
+            std::lock_guard lock(mutex);
+            ++generation;
+            lru.clear();
+            index.clear();
+            charge = 0;
+        }
+
+        void Evict() {
+            while (!lru.empty() && (charge > capacity_bytes || (max_entries != 0 && lru.size() > max_entries))) {
+                auto victim = std::prev(lru.end());
+                auto found = index.find(victim->key);
+                std::erase(found->second, victim);
+                if (found->second.empty()) {
+                    index.erase(found);
+                }
+                charge -= victim->charge;
+                lru.erase(victim);
+            }
+        }
+    };
+
+    auto ShardFor(std::string_view key) -> Shard& {
+        return shards_[std::hash<std::string_view>{}(key) % shards_.size()];
+    }
+
+    std::vector<Shard> shards_;
+};
+
+}  // namespace oryx
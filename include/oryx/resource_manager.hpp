@@ -0,0 +1,131 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+#include <leveldb/cache.h>
+#include <leveldb/options.h>
+
+namespace oryx {
+
+struct ResourceBudget {
+    // One block cache shared by all databases instead of leveldb's 8 MB per database.
+    size_t block_cache_bytes = 64 * 1024 * 1024;
+    // Memtable budget over all open databases, none gets more than write_buffer_bytes_per_database.
+    size_t write_buffer_bytes = 64 * 1024 * 1024;
+    size_t write_buffer_bytes_per_database = 4 * 1024 * 1024;
+    // Table file budget over all open databases, none gets more than open_files_per_database.
+    size_t open_files = 4096;
+    size_t open_files_per_database = 1000;
+};
+
+// Hands out one shared block cache and splits the write buffer and open files budgets over the databases opened
+// through it. leveldb fixes both when a database is opened, so the budgets are rebalanced on open and close: a
+// database gets an equal share of the budget, or what the open databases left of it, and its share is returned
+// when it is closed. Shares never go below leveldb's minimums of 64 KB and 74 files, which can exceed the budget
+// once it is exhausted. Must outlive the databases opened through it.
+class ResourceManager {
+public:
+    static constexpr size_t kMinWriteBufferBytes = 64 * 1024;
+    static constexpr size_t kMinOpenFiles = 74;
+
+    // Returns its share to the manager when destroyed.
+    class Lease {
+    public:
+        Lease(const Lease&) = delete;
+        auto operator=(const Lease&) -> Lease& = delete;
+
+        ~Lease() { manager_.Release(write_buffer_bytes_, open_files_); }
+
+        [[nodiscard]] auto write_buffer_bytes() const -> size_t { return write_buffer_bytes_; }
+        [[nodiscard]] auto open_files() const -> size_t { return open_files_; }
+
+    private:
+        friend class ResourceManager;
+
+        Lease(ResourceManager& manager, size_t write_buffer_bytes, size_t open_files)
+            : manager_(manager),
+              write_buffer_bytes_(write_buffer_bytes),
+              open_files_(open_files) {}
+
+        ResourceManager& manager_;
+        size_t write_buffer_bytes_;
+        size_t open_files_;
+    };
+
+    explicit ResourceManager(const ResourceBudget& budget = {})
+        : budget_(budget),
+          cache_(leveldb::NewLRUCache(budget.block_cache_bytes)) {}
+
+    ResourceManager(const ResourceManager&) = delete;
+    auto operator=(const ResourceManager&) -> ResourceManager& = delete;
+
+    // Process wide manager with the default budget. Never destroyed, so databases that are destroyed during
+    // static destruction can still return their share.
+    static auto Default() -> ResourceManager& {
+        static auto* manager = new ResourceManager();
+        return *manager;
+    }
+
+    // Points opts at the shared cache and sets its write buffer size and open files to the share of the database
+    // about to be opened, which it holds until the returned lease is destroyed.
+    [[nodiscard]] auto Acquire(leveldb::Options& opts) -> std::unique_ptr<Lease> {
+        std::lock_guard lock(mutex_);
+        const size_t databases = ++databases_;
+        const size_t write_buffer_bytes = Share(budget_.write_buffer_bytes, write_buffer_bytes_in_use_,
+                                                budget_.write_buffer_bytes_per_database, databases,
+                                                kMinWriteBufferBytes);
+        const size_t open_files =
+            Share(budget_.open_files, open_files_in_use_, budget_.open_files_per_database, databases, kMinOpenFiles);
+        write_buffer_bytes_in_use_ += write_buffer_bytes;
+        open_files_in_use_ += open_files;
+
+        opts.block_cache = cache_.get();
+        opts.write_buffer_size = write_buffer_bytes;
+        opts.max_open_files = static_cast<int>(open_files);
+        return std::unique_ptr<Lease>(new Lease(*this, write_buffer_bytes, open_files));
+    }
+
+    [[nodiscard]] auto cache() const -> leveldb::Cache* { return cache_.get(); }
+    [[nodiscard]] auto budget() const -> const ResourceBudget& { return budget_; }
+
+    [[nodiscard]] auto open_databases() const -> size_t {
+        std::lock_guard lock(mutex_);
+        return databases_;
+    }
+
+    [[nodiscard]] auto write_buffer_bytes_in_use() const -> size_t {
+        std::lock_guard lock(mutex_);
+        return write_buffer_bytes_in_use_;
+    }
+
+    [[nodiscard]] auto open_files_in_use() const -> size_t {
+        std::lock_guard lock(mutex_);
+        return open_files_in_use_;
+    }
+
+private:
+    static auto Share(size_t budget, size_t in_use, size_t per_database, size_t databases, size_t minimum)
+        -> size_t {
+        const size_t available = budget > in_use ? budget - in_use : 0;
+        return std::max(minimum, std::min({per_database, budget / databases, available}));
+    }
+
+    void Release(size_t write_buffer_bytes, size_t open_files) {
+        std::lock_guard lock(mutex_);
+        --databases_;
+        write_buffer_bytes_in_use_ -= write_buffer_bytes;
+        open_files_in_use_ -= open_files;
+    }
+
+    ResourceBudget budget_;
+    std::unique_ptr<leveldb::Cache> cache_;
+    mutable std::mutex mutex_{};
+    size_t databases_{0};
+    size_t write_buffer_bytes_in_use_{0};
+    size_t open_files_in_use_{0};
+};
+
+}  // namespace oryx
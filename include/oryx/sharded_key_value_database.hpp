@@ -0,0 +1,309 @@
+#pragma once
+
+#include <cstdio>
+#include <filesystem>
+#include <future>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <oryx/key_value_database.hpp>
+
+namespace oryx {
+
+// Hash partitions keys over multiple leveldb instances stored under one directory,
+// so writes and compactions are spread over independent write queues and compaction threads.
+// The shard count is fixed once a database has been created.
+template <typename Codec = JsonCodec, StorageBackend Backend = LevelDbBackend>
+class BasicShardedKeyValueDatabase {
+public:
+    using codec_type = Codec;
+    using backend_type = Backend;
+    using shard_type = BasicKeyValueDatabase<Codec, Backend>;
+
+    BasicShardedKeyValueDatabase() = default;
+
+    // Opens shard_count shards in parallel under the directory name.
+    auto Open(const std::string& name,
+              size_t shard_count,
+              const leveldb::Options& opts = shard_type::DefaultOptions()) -> leveldb::Status {
+        Close();
+
+        if (shard_count == 0) {
+            return leveldb::Status::InvalidArgument("Shard count must be greater than zero");
+        }
+
+        // In memory shards start empty, there is no directory to create or shard count to check.
+        if constexpr (stores_on_disk_v<Backend>) {
+            std::error_code ec;
+            if (opts.create_if_missing) {
+                std::filesystem::create_directories(name, ec);
+                if (ec) {
+                    return leveldb::Status::IOError(name, ec.message());
+                }
+            }
+
+            if (const size_t existing = CountShards(name); existing != 0 && existing != shard_count) {
+                return leveldb::Status::InvalidArgument(
+                    name,
+                    "was created with " + std::to_string(existing) + " shards, not " + std::to_string(shard_count));
+            }
+        }
+
+        std::vector<shard_type> shards(shard_count);
+        if (resources_) {
+            for (auto& shard : shards) {
+                shard.EnableSharedResources(*resources_);
+            }
+        }
+        std::vector<std::future<leveldb::Status>> opened;
+        opened.reserve(shard_count);
+        for (size_t i = 0; i < shard_count; ++i) {
+            opened.push_back(
+                std::async(std::launch::async, [&, i] { return shards[i].Open(ShardPath(name, i), opts); }));
+        }
+
+        leveldb::Status status{};
+        for (auto& result : opened) {
+            if (auto shard_status = result.get(); status.ok() && !shard_status.ok()) {
+                status = shard_status;
+            }
+        }
+        if (!status.ok()) {
+            return status;
+        }
+
+        for (auto& shard : shards) {
+            shard.SetDurability(durability_, group_commit_opts_);
+            if (cache_opts_) {
+                shard.EnableObjectCache(*cache_opts_);
+            }
+            if (negative_cache_opts_) {
+                shard.EnableNegativeCache(*negative_cache_opts_);
+            }
+            // Moving the vector below keeps the shards in place.
+            if (write_behind_opts_) {
+                shard.EnableWriteBehind(*write_behind_opts_);
+            }
+        }
+        shards_ = std::move(shards);
+        return status;
+    }
+
+    void Close() { shards_.clear(); }
+
+    template <typename T>
+    auto Get(const leveldb::Slice& key, T&& val, const leveldb::ReadOptions& opts = shard_type::DefaultReadOptions())
+        -> leveldb::Status {
+        if (!IsOpen()) {
+            return NotOpen();
+        }
+        return ShardFor(key).Get(key, std::forward<T>(val), opts);
+    }
+
+    auto Contains(const leveldb::Slice& key, const leveldb::ReadOptions& opts = shard_type::DefaultReadOptions())
+        -> bool {
+        return IsOpen() && ShardFor(key).Contains(key, opts);
+    }
+
+    template <auto Member>
+    auto GetField(const leveldb::Slice& key,
+                  detail::member_type_t<Member>& val,
+                  const leveldb::ReadOptions& opts = shard_type::DefaultReadOptions()) -> leveldb::Status {
+        if (!IsOpen()) {
+            return NotOpen();
+        }
+        return ShardFor(key).template GetField<Member>(key, val, opts);
+    }
+
+    template <typename T>
+    auto Put(const leveldb::Slice& key,
+             const T& obj,
+             const leveldb::WriteOptions& opts = shard_type::DefaultWriteOptions()) -> leveldb::Status {
+        if (!IsOpen()) {
+            return NotOpen();
+        }
+        return ShardFor(key).Put(key, obj, opts);
+    }
+
+    template <typename T, typename Fn>
+    auto Update(const leveldb::Slice& key,
+                Fn&& fn,
+                const leveldb::WriteOptions& opts = shard_type::DefaultWriteOptions()) -> leveldb::Status {
+        if (!IsOpen()) {
+            return NotOpen();
+        }
+        return ShardFor(key).template Update<T>(key, std::forward<Fn>(fn), opts);
+    }
+
+    auto Delete(const leveldb::Slice& key, const leveldb::WriteOptions& opts = shard_type::DefaultWriteOptions())
+        -> leveldb::Status {
+        if (!IsOpen()) {
+            return NotOpen();
+        }
+        return ShardFor(key).Delete(key, opts);
+    }
+
+    // Applies to every shard, see BasicKeyValueDatabase::SetDurability.
+    void SetDurability(Durability mode, const GroupCommitOptions& opts = {}) {
+        durability_ = mode;
+        group_commit_opts_ = opts;
+        for (auto& shard : shards_) {
+            shard.SetDurability(mode, opts);
+        }
+    }
+
+    // Every shard holds its own share, see BasicKeyValueDatabase::EnableSharedResources.
+    void EnableSharedResources(ResourceManager& manager = ResourceManager::Default()) { resources_ = &manager; }
+    void DisableSharedResources() { resources_ = nullptr; }
+
+    // Every shard gets its own cache with the given budget, see BasicKeyValueDatabase::EnableObjectCache.
+    void EnableObjectCache(const ObjectCacheOptions& opts = {}) {
+        cache_opts_ = opts;
+        for (auto& shard : shards_) {
+            shard.EnableObjectCache(opts);
+        }
+    }
+
+    void DisableObjectCache() {
+        cache_opts_.reset();
+        for (auto& shard : shards_) {
+            shard.DisableObjectCache();
+        }
+    }
+
+    // Every shard gets its own cache with the given budget, see BasicKeyValueDatabase::EnableNegativeCache.
+    void EnableNegativeCache(const NegativeCacheOptions& opts = {}) {
+        negative_cache_opts_ = opts;
+        for (auto& shard : shards_) {
+            shard.EnableNegativeCache(opts);
+        }
+    }
+
+    void DisableNegativeCache() {
+        negative_cache_opts_.reset();
+        for (auto& shard : shards_) {
+            shard.DisableNegativeCache();
+        }
+    }
+
+    // Every shard gets its own buffer with the given budget, see BasicKeyValueDatabase::EnableWriteBehind.
+    void EnableWriteBehind(const WriteBehindOptions& opts = {}) {
+        write_behind_opts_ = opts;
+        for (auto& shard : shards_) {
+            shard.EnableWriteBehind(opts);
+        }
+    }
+
+    auto DisableWriteBehind() -> leveldb::Status {
+        write_behind_opts_.reset();
+        leveldb::Status status{};
+        for (auto& shard : shards_) {
+            if (auto shard_status = shard.DisableWriteBehind(); status.ok() && !shard_status.ok()) {
+                status = shard_status;
+            }
+        }
+        return status;
+    }
+
+    auto Flush() -> leveldb::Status {
+        leveldb::Status status{};
+        for (auto& shard : shards_) {
+            if (auto shard_status = shard.Flush(); status.ok() && !shard_status.ok()) {
+                status = shard_status;
+            }
+        }
+        return status;
+    }
+
+#ifdef ORYX_KVDB_ZSTD
+    // Every shard keeps its own dictionary, see BasicKeyValueDatabase::RegisterDictionary.
+    template <typename T>
+    auto RegisterDictionary(const std::string& name, const DictionaryOptions& opts = {}) -> leveldb::Status {
+        for (auto& shard : shards_) {
+            if (auto status = shard.template RegisterDictionary<T>(name, opts); !status.ok()) {
+                return status;
+            }
+        }
+        return leveldb::Status::OK();
+    }
+
+    // Trains every shard's dictionary from its own values, see BasicKeyValueDatabase::TrainDictionary.
+    auto TrainDictionary(const std::string& name, const leveldb::Slice& prefix, const DictionaryOptions& opts = {})
+        -> leveldb::Status {
+        for (auto& shard : shards_) {
+            if (auto status = shard.TrainDictionary(name, prefix, opts); !status.ok()) {
+                return status;
+            }
+        }
+        return leveldb::Status::OK();
+    }
+#endif
+
+    // Sum over all shards, see BasicKeyValueDatabase::Metrics.
+    [[nodiscard]] auto Metrics() const -> DatabaseMetrics {
+        DatabaseMetrics total{};
+        for (const auto& shard : shards_) {
+            total.Merge(shard.Metrics());
+        }
+        return total;
+    }
+
+    // Sum over all shards, see BasicKeyValueDatabase::Stats.
+    auto Stats(EngineStats& stats) const -> leveldb::Status {
+        stats = EngineStats{};
+        for (const auto& shard : shards_) {
+            EngineStats shard_stats{};
+            if (auto status = shard.Stats(shard_stats); !status.ok()) {
+                return status;
+            }
+            stats.Merge(shard_stats);
+        }
+        return leveldb::Status::OK();
+    }
+
+    [[nodiscard]] auto IsOpen() const -> bool { return !shards_.empty(); }
+    [[nodiscard]] auto shard_count() const -> size_t { return shards_.size(); }
+    [[nodiscard]] auto shard(size_t index) -> shard_type& { return shards_[index]; }
+    // Zero while the database is not open.
+    [[nodiscard]] auto ShardIndex(const leveldb::Slice& key) const -> size_t {
+        if (shards_.empty()) {
+            return 0;
+        }
+        return detail::Fnv1a(std::string_view(key.data(), key.size())) % shards_.size();
+    }
+
+private:
+    static auto NotOpen() -> leveldb::Status { return leveldb::Status::InvalidArgument("Database is not open"); }
+
+    auto ShardFor(const leveldb::Slice& key) -> shard_type& { return shards_[ShardIndex(key)]; }
+
+    static auto ShardPath(const std::string& name, size_t index) -> std::string {
+        char shard[32];
+        std::snprintf(shard, sizeof(shard), "shard-%03zu", index);
+        return (std::filesystem::path(name) / shard).string();
+    }
+
+    static auto CountShards(const std::string& name) -> size_t {
+        std::error_code ec;
+        size_t count = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(name, ec)) {
+            if (entry.is_directory() && entry.path().filename().string().starts_with("shard-")) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    std::vector<shard_type> shards_{};
+    Durability durability_{Durability::kSync};
+    GroupCommitOptions group_commit_opts_{};
+    std::optional<ObjectCacheOptions> cache_opts_{};
+    std::optional<NegativeCacheOptions> negative_cache_opts_{};
+    std::optional<WriteBehindOptions> write_behind_opts_{};
+    ResourceManager* resources_{nullptr};
+};
+
+using ShardedKeyValueDatabase = BasicShardedKeyValueDatabase<>;
+
+}  // namespace oryx
@@ -0,0 +1,245 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <concepts>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <utility>
+
+#include <leveldb/status.h>
+
+namespace oryx {
+
+struct LevelStats {
+    uint64_t files{0};
+    uint64_t size_bytes{0};
+    // Compactions that wrote into this level.
+    double compaction_seconds{0};
+    double compaction_read_mb{0};
+    double compaction_written_mb{0};
+};
+
+// Typed view of the leveldb properties.
+struct EngineStats {
+    // leveldb::config::kNumLevels.
+    static constexpr size_t kLevels = 7;
+    // leveldb delays every write by 1 ms from this many level 0 files on and stops writes at kLevel0StopWrites
+    // until a compaction caught up.
+    static constexpr uint64_t kLevel0SlowdownWrites = 8;
+    static constexpr uint64_t kLevel0StopWrites = 12;
+
+    std::array<LevelStats, kLevels> levels{};
+    // Memtables and block cache in bytes.
+    uint64_t approximate_memory_usage{0};
+
+    [[nodiscard]] auto sstables() const -> uint64_t {
+        uint64_t total = 0;
+        for (const auto& level : levels) {
+            total += level.files;
+        }
+        return total;
+    }
+
+    [[nodiscard]] auto size_bytes() const -> uint64_t {
+        uint64_t total = 0;
+        for (const auto& level : levels) {
+            total += level.size_bytes;
+        }
+        return total;
+    }
+
+    [[nodiscard]] auto compaction_read_mb() const -> double {
+        double total = 0;
+        for (const auto& level : levels) {
+            total += level.compaction_read_mb;
+        }
+        return total;
+    }
+
+    [[nodiscard]] auto compaction_written_mb() const -> double {
+        double total = 0;
+        for (const auto& level : levels) {
+            total += level.compaction_written_mb;
+        }
+        return total;
+    }
+
+    // Level 0 files pile up when compactions fall behind the write rate, which leveldb answers by delaying writes.
+    [[nodiscard]] auto writes_slowed() const -> bool { return levels[0].files >= kLevel0SlowdownWrites; }
+    [[nodiscard]] auto writes_stopped() const -> bool { return levels[0].files >= kLevel0StopWrites; }
+
+    void Merge(const EngineStats& other) {
+        for (size_t i = 0; i < kLevels; ++i) {
+            levels[i].files += other.levels[i].files;
+            levels[i].size_bytes += other.levels[i].size_bytes;
+            levels[i].compaction_seconds += other.levels[i].compaction_seconds;
+            levels[i].compaction_read_mb += other.levels[i].compaction_read_mb;
+            levels[i].compaction_written_mb += other.levels[i].compaction_written_mb;
+        }
+        approximate_memory_usage += other.approximate_memory_usage;
+    }
+};
+
+namespace detail {
+
+template <typename T>
+auto ConsumeNumber(std::string_view& text, T& value) -> bool {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (result.ec != std::errc{}) {
+        return false;
+    }
+    text.remove_prefix(static_cast<size_t>(result.ptr - text.data()));
+    return true;
+}
+
+// Parses the compactions of the table of the leveldb.stats property:
+//                                Compactions
+// Level  Files Size(MB) Time(sec) Read(MB) Write(MB)
+// --------------------------------------------------
+//   0        2        0         0        0         0
+// Levels without files or compactions are not listed. Sizes are rounded to whole megabytes, so the size column is
+// skipped in favour of ParseTableSizes.
+inline auto ParseLevelStats(std::string_view text, EngineStats& stats) -> bool {
+    const size_t table = text.find("---\n");
+    if (table == std::string_view::npos) {
+        return false;
+    }
+    text.remove_prefix(table + 4);
+
+    while (!text.empty()) {
+        const size_t end = text.find('\n');
+        std::string_view line = text.substr(0, end);
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+        if (line.find_first_not_of(" \t") == std::string_view::npos) {
+            continue;
+        }
+
+        size_t level = 0;
+        double size_mb = 0;
+        LevelStats parsed{};
+        if (!ConsumeNumber(line, level) || level >= EngineStats::kLevels || !ConsumeNumber(line, parsed.files) ||
+            !ConsumeNumber(line, size_mb) || !ConsumeNumber(line, parsed.compaction_seconds) ||
+            !ConsumeNumber(line, parsed.compaction_read_mb) || !ConsumeNumber(line, parsed.compaction_written_mb)) {
+            return false;
+        }
+        parsed.size_bytes = stats.levels[level].size_bytes;
+        stats.levels[level] = parsed;
+    }
+    return true;
+}
+
+// Sums the file sizes in bytes per level from the leveldb.sstables property:
+// --- level 0 ---
+//  7:1534['a' @ 3 : 1 .. 'c' @ 5 : 1]
+inline auto ParseTableSizes(std::string_view text, EngineStats& stats) -> bool {
+    constexpr std::string_view kLevelHeader = "--- level ";
+    std::optional<size_t> level{};
+
+    while (!text.empty()) {
+        const size_t end = text.find('\n');
+        std::string_view line = text.substr(0, end);
+        text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+        if (line.find_first_not_of(" \t") == std::string_view::npos) {
+            continue;
+        }
+
+        if (line.starts_with(kLevelHeader)) {
+            line.remove_prefix(kLevelHeader.size());
+            size_t parsed = 0;
+            if (!ConsumeNumber(line, parsed) || parsed >= EngineStats::kLevels) {
+                return false;
+            }
+            level = parsed;
+            stats.levels[parsed].size_bytes = 0;
+            continue;
+        }
+
+        uint64_t number = 0;
+        uint64_t size = 0;
+        if (!level || !ConsumeNumber(line, number) || !line.starts_with(':')) {
+            return false;
+        }
+        line.remove_prefix(1);
+        if (!ConsumeNumber(line, size)) {
+            return false;
+        }
+        stats.levels[*level].size_bytes += size;
+    }
+    return true;
+}
+
+}  // namespace detail
+
+// Takes a sample every interval on a background thread and hands it to on_sample, for example to alert when
+// level 0 grows towards EngineStats::kLevel0SlowdownWrites. The database has to stay open while the sampler
+// exists.
+class StatsSampler {
+public:
+    using OnSample = std::function<void(const EngineStats&)>;
+
+    template <typename Db>
+        requires requires(Db& db, EngineStats& stats) {
+            { db.Stats(stats) } -> std::same_as<leveldb::Status>;
+        }
+    StatsSampler(Db& db, std::chrono::milliseconds interval, OnSample on_sample = {})
+        : sample_([&db](EngineStats& stats) { return db.Stats(stats); }),
+          interval_(interval),
+          on_sample_(std::move(on_sample)),
+          thread_([this] { Run(); }) {}
+
+    StatsSampler(const StatsSampler&) = delete;
+    auto operator=(const StatsSampler&) -> StatsSampler& = delete;
+
+    ~StatsSampler() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_one();
+        thread_.join();
+    }
+
+    // Most recent successful sample, none before the first interval passed.
+    [[nodiscard]] auto latest() const -> std::optional<EngineStats> {
+        std::lock_guard lock(mutex_);
+        return latest_;
+    }
+
+private:
+    void Run() {
+        std::unique_lock lock(mutex_);
+        while (!cv_.wait_for(lock, interval_, [this] { return stop_; })) {
+            lock.unlock();
+            EngineStats stats{};
+            const bool sampled = sample_(stats).ok();
+            if (sampled && on_sample_) {
+                on_sample_(stats);
+            }
+            lock.lock();
+            if (sampled) {
+                latest_ = stats;
+            }
+        }
+    }
+
+    std::function<leveldb::Status(EngineStats&)> sample_;
+    std::chrono::milliseconds interval_;
+    OnSample on_sample_;
+    mutable std::mutex mutex_{};
+    std::condition_variable cv_{};
+    bool stop_{false};
+    std::optional<EngineStats> latest_{};
+    std::thread thread_;
+};
+
+}  // namespace oryx
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <optional>
+#include <string_view>
+
+namespace oryx::detail {
+
+// Compresses the encoded values of a type after the codec ran and before they are stored,
+// see BasicKeyValueDatabase::RegisterDictionary.
+class ValueCompressor {
+public:
+    virtual ~ValueCompressor() = default;
+
+    // Returns a view of the compressed val that is valid until the next call on this thread,
+    // nullopt to store val as is.
+    [[nodiscard]] virtual auto Compress(std::string_view val) const -> std::optional<std::string_view> = 0;
+
+    // Returns val itself if it was stored as is, otherwise a view of the decompressed val that is valid until
+    // the next call on this thread. nullopt if val can not be decompressed.
+    [[nodiscard]] virtual auto Decompress(std::string_view val) const -> std::optional<std::string_view> = 0;
+};
+
+}  // namespace oryx::detail
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#include <leveldb/status.h>
+#include <leveldb/write_batch.h>
+
+namespace oryx {
+
+struct WriteBehindOptions {
+    // Upper bound for how long a write stays only in memory.
+    std::chrono::milliseconds interval{100};
+    // The write that grows the buffered keys and values past this many bytes flushes them on its own thread.
+    size_t max_buffered_bytes = 4 * 1024 * 1024;
+};
+
+namespace detail {
+
+// Keeps the latest write per key in memory and hands them to flush as one batch, so a key overwritten many times
+// between two flushes is written once.
+class WriteBehindBuffer {
+public:
+    using Flush = std::function<leveldb::Status(leveldb::WriteBatch&, bool sync)>;
+
+    WriteBehindBuffer(const WriteBehindOptions& opts, Flush flush)
+        : opts_(opts),
+          flush_(std::move(flush)),
+          thread_([this] { Run(); }) {}
+
+    WriteBehindBuffer(const WriteBehindBuffer&) = delete;
+    auto operator=(const WriteBehindBuffer&) -> WriteBehindBuffer& = delete;
+
+    // Flushes whatever is still buffered.
+    ~WriteBehindBuffer() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        cv_.notify_one();
+        thread_.join();
+        FlushBuffered();
+    }
+
+    // Returns the status of the flush when this write filled the buffer, OK otherwise.
+    auto Put(std::string_view key, std::string_view value, bool sync) -> leveldb::Status {
+        std::unique_lock lock(mutex_);
+        Buffer(key, value, sync);
+        return FlushIfFull(lock);
+    }
+
+    auto Delete(std::string_view key, bool sync) -> leveldb::Status {
+        std::unique_lock lock(mutex_);
+        Buffer(key, std::nullopt, sync);
+        return FlushIfFull(lock);
+    }
+
+    // All updates of batch become visible together and are flushed in the same batch.
+    auto Write(const leveldb::WriteBatch& batch, bool sync) -> leveldb::Status {
+        struct Handler : leveldb::WriteBatch::Handler {
+            Handler(WriteBehindBuffer& buffer, bool sync)
+                : buffer(buffer),
+                  sync(sync) {}
+
+            void Put(const leveldb::Slice& key, const leveldb::Slice& value) override {
+                buffer.Buffer(std::string_view(key.data(), key.size()), std::string_view(value.data(), value.size()),
+                              sync);
+            }
+            void Delete(const leveldb::Slice& key) override {
+                buffer.Buffer(std::string_view(key.data(), key.size()), std::nullopt, sync);
+            }
+
+            WriteBehindBuffer& buffer;
+            bool sync;
+        } handler(*this, sync);
+
+        std::unique_lock lock(mutex_);
+        if (auto status = batch.Iterate(&handler); !status.ok()) {
+            return status;
+        }
+        return FlushIfFull(lock);
+    }
+
+    // Copies the buffered value of key into value. Returns NotFound for a buffered delete and std::nullopt when
+    // key has no buffered write.
+    auto Find(std::string_view key, std::string& value) const -> std::optional<leveldb::Status> {
+        std::lock_guard lock(mutex_);
+        auto found = pending_.find(key);
+        if (found == pending_.end()) {
+            found = flushing_.find(key);
+            if (found == flushing_.end()) {
+                return std::nullopt;
+            }
+        }
+        if (!found->second) {
+            return leveldb::Status::NotFound(leveldb::Slice());
+        }
+        value.assign(*found->second);
+        return leveldb::Status::OK();
+    }
+
+    // Writes everything buffered so far. A failed flush keeps its writes for the next one unless they were
+    // overwritten meanwhile.
+    auto FlushBuffered() -> leveldb::Status {
+        std::lock_guard flushing(flush_mutex_);
+        bool sync = false;
+        {
+            std::lock_guard lock(mutex_);
+            if (pending_.empty()) {
+                return leveldb::Status::OK();
+            }
+            flushing_.swap(pending_);
+            pending_bytes_ = 0;
+            sync = std::exchange(pending_sync_, false);
+        }
+
+        // Only this thread modifies flushing_, readers hold mutex_ and do not.
+        leveldb::WriteBatch batch{};
+        for (const auto& [key, value] : flushing_) {
+            if (value) {
+                batch.Put(key, *value);
+            } else {
+                batch.Delete(key);
+            }
+        }
+        const leveldb::Status status = flush_(batch, sync);
+
+        std::lock_guard lock(mutex_);
+        if (!status.ok()) {
+            while (!flushing_.empty()) {
+                auto entry = flushing_.extract(flushing_.begin());
+                const size_t bytes = Bytes(entry.key(), entry.mapped());
+                if (pending_.insert(std::move(entry)).inserted) {
+                    pending_bytes_ += bytes;
+                }
+            }
+            pending_sync_ = pending_sync_ || sync;
+        }
+        flushing_.clear();
+        return status;
+    }
+
+    [[nodiscard]] auto buffered_bytes() const -> size_t {
+        std::lock_guard lock(mutex_);
+        return pending_bytes_;
+    }
+
+private:
+    struct StringHash {
+        using is_transparent = void;
+        auto operator()(std::string_view s) const -> size_t { return std::hash<std::string_view>{}(s); }
+    };
+
+    // std::nullopt marks a delete.
+    using Entries = std::unordered_map<std::string, std::optional<std::string>, StringHash, std::equal_to<>>;
+
+    static auto Bytes(std::string_view key, const std::optional<std::string>& value) -> size_t {
+        return key.size() + (value ? value->size() : 0);
+    }
+
+    // Called with mutex_ held, an overwrite reuses the memory of the value it replaces.
+    void Buffer(std::string_view key, std::optional<std::string_view> value, bool sync) {
+        auto found = pending_.find(key);
+        if (found == pending_.end()) {
+            found = pending_.try_emplace(std::string(key)).first;
+        } else {
+            pending_bytes_ -= Bytes(key, found->second);
+        }
+
+        if (!value) {
+            found->second.reset();
+        } else if (found->second) {
+            found->second->assign(*value);
+        } else {
+            found->second.emplace(*value);
+        }
+        pending_bytes_ += Bytes(key, found->second);
+        pending_sync_ = pending_sync_ || sync;
+    }
+
+    auto FlushIfFull(std::unique_lock<std::mutex>& lock) -> leveldb::Status {
+        if (pending_bytes_ < opts_.max_buffered_bytes) {
+            return leveldb::Status::OK();
+        }
+        lock.unlock();
+        return FlushBuffered();
+    }
+
+    // A failed flush keeps its writes, they are retried on the next interval.
+    void Run() {
+        std::unique_lock lock(mutex_);
+        while (!stop_) {
+            cv_.wait_for(lock, opts_.interval, [this] { return stop_; });
+            if (stop_) {
+                return;
+            }
+            lock.unlock();
+            FlushBuffered();
+            lock.lock();
+        }
+    }
+
+    WriteBehindOptions opts_;
+    Flush flush_;
+    mutable std::mutex mutex_{};
+    // Serializes flushes so a later flush can not overtake an earlier one.
+    std::mutex flush_mutex_{};
+    std::condition_variable cv_{};
+    bool stop_{false};
+    Entries pending_{};
+    // Taken out of pending_ by the running flush, still visible to readers until it is written.
+    Entries flushing_{};
+    size_t pending_bytes_{0};
+    bool pending_sync_{false};
+    std::thread thread_;
+};
+
+}  // namespace detail
+}  // namespace oryx
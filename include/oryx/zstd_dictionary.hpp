@@ -0,0 +1,228 @@
+#pragma once
+
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <zdict.h>
+#include <zstd.h>
+
+#include <oryx/value_compressor.hpp>
+
+namespace oryx {
+
+struct DictionaryOptions {
+    // Upper bound of a trained dictionary.
+    size_t max_dictionary_bytes = 110 * 1024;
+    // Number of values sampled when training.
+    size_t max_samples = 10000;
+    // zstd level values are compressed with.
+    int level = 3;
+    // Larger values are stored as is, and compressed values claiming a larger size fail to read instead of
+    // allocating whatever a corrupted frame header asks for.
+    size_t max_value_bytes = 16 * 1024 * 1024;
+};
+
+namespace detail {
+
+// Dictionaries are stored under "\0kvdb.dict.<name>/<version>" next to the values they compress.
+inline constexpr std::string_view kDictionaryKeyPrefix{"\0kvdb.dict.", 11};
+
+inline auto DictionaryKeyPrefix(std::string_view name) -> std::string {
+    std::string key(kDictionaryKeyPrefix);
+    key.append(name);
+    key.push_back('/');
+    return key;
+}
+
+// Versions are fixed width hex so they sort in key order.
+inline auto DictionaryKey(std::string_view name, uint32_t version) -> std::string {
+    char suffix[9];
+    std::snprintf(suffix, sizeof(suffix), "%08x", version);
+    return DictionaryKeyPrefix(name) + suffix;
+}
+
+inline auto DictionaryVersion(std::string_view key, std::string_view prefix) -> std::optional<uint32_t> {
+    if (!key.starts_with(prefix) || key.size() != prefix.size() + 8) {
+        return std::nullopt;
+    }
+    uint32_t version = 0;
+    const char* end = key.data() + key.size();
+    if (std::from_chars(key.data() + prefix.size(), end, version, 16).ptr != end) {
+        return std::nullopt;
+    }
+    return version;
+}
+
+// Trains a zstd dictionary from samples, nullopt if zstd could not build one, usually because of too few samples.
+inline auto TrainZstdDictionary(const std::vector<std::string>& samples, size_t max_dictionary_bytes)
+    -> std::optional<std::string> {
+    std::string joined;
+    std::vector<size_t> sizes;
+    sizes.reserve(samples.size());
+    for (const auto& sample : samples) {
+        joined.append(sample);
+        sizes.push_back(sample.size());
+    }
+
+    std::string dictionary(max_dictionary_bytes, '\0');
+    const size_t size = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(), joined.data(), sizes.data(),
+                                              static_cast<unsigned>(sizes.size()));
+    if (ZDICT_isError(size)) {
+        return std::nullopt;
+    }
+    dictionary.resize(size);
+    return dictionary;
+}
+
+// Compresses values with the latest version of a dictionary and decompresses them with the version they were
+// compressed with. Compressed values are a tag byte, the version as 4 bytes little endian and a zstd frame.
+class ZstdDictionaryCompressor final : public ValueCompressor {
+public:
+    static constexpr char kTag = '\x04';
+    static constexpr size_t kHeaderSize = 1 + sizeof(uint32_t);
+
+    explicit ZstdDictionaryCompressor(int level, size_t max_value_bytes = DictionaryOptions{}.max_value_bytes)
+        : level_(level),
+          max_value_bytes_(max_value_bytes) {}
+
+    auto AddVersion(uint32_t version, std::string_view dictionary) -> bool {
+        Version loaded{
+            CDictPtr(ZSTD_createCDict(dictionary.data(), dictionary.size(), level_)),
+            DDictPtr(ZSTD_createDDict(dictionary.data(), dictionary.size())),
+        };
+        if (!loaded.cdict || !loaded.ddict) {
+            return false;
+        }
+
+        std::unique_lock lock(mutex_);
+        versions_.insert_or_assign(version, std::move(loaded));
+        return true;
+    }
+
+    // 0 if no dictionary was trained yet.
+    [[nodiscard]] auto latest_version() const -> uint32_t {
+        std::shared_lock lock(mutex_);
+        return versions_.empty() ? 0 : versions_.rbegin()->first;
+    }
+
+    [[nodiscard]] auto Compress(std::string_view val) const -> std::optional<std::string_view> override {
+        if (val.size() > max_value_bytes_) {
+            return std::nullopt;
+        }
+
+        std::shared_lock lock(mutex_);
+        if (versions_.empty()) {
+            return std::nullopt;
+        }
+        const auto& [version, latest] = *versions_.rbegin();
+
+        thread_local std::string out;
+        out.resize(kHeaderSize + ZSTD_compressBound(val.size()));
+        out.front() = kTag;
+        StoreVersion(version, out.data() + 1);
+        const size_t size = ZSTD_compress_usingCDict(CCtx(), out.data() + kHeaderSize, out.size() - kHeaderSize,
+                                                     val.data(), val.size(), latest.cdict.get());
+        // Not worth it, keeps values that do not compress readable without the dictionary.
+        if (ZSTD_isError(size) || kHeaderSize + size >= val.size()) {
+            return std::nullopt;
+        }
+        return std::string_view(out.data(), kHeaderSize + size);
+    }
+
+    [[nodiscard]] auto Decompress(std::string_view val) const -> std::optional<std::string_view> override {
+        if (val.empty() || val.front() != kTag) {
+            return val;
+        }
+        if (val.size() < kHeaderSize) {
+            return std::nullopt;
+        }
+
+        const std::string_view frame = val.substr(kHeaderSize);
+        const unsigned long long content_size = ZSTD_getFrameContentSize(frame.data(), frame.size());
+        if (content_size == ZSTD_CONTENTSIZE_UNKNOWN || content_size == ZSTD_CONTENTSIZE_ERROR ||
+            content_size > max_value_bytes_) {
+            return std::nullopt;
+        }
+
+        std::shared_lock lock(mutex_);
+        const auto found = versions_.find(LoadVersion(val.data() + 1));
+        if (found == versions_.end()) {
+            return std::nullopt;
+        }
+
+        thread_local std::string out;
+        out.resize(content_size);
+        const size_t size = ZSTD_decompress_usingDDict(DCtx(), out.data(), out.size(), frame.data(), frame.size(),
+                                                       found->second.ddict.get());
+        if (ZSTD_isError(size) || size != content_size) {
+            return std::nullopt;
+        }
+        return std::string_view(out.data(), size);
+    }
+
+private:
+    struct CDictDeleter {
+        void operator()(ZSTD_CDict* dict) const { ZSTD_freeCDict(dict); }
+    };
+    struct DDictDeleter {
+        void operator()(ZSTD_DDict* dict) const { ZSTD_freeDDict(dict); }
+    };
+    struct CCtxDeleter {
+        void operator()(ZSTD_CCtx* ctx) const { ZSTD_freeCCtx(ctx); }
+    };
+    struct DCtxDeleter {
+        void operator()(ZSTD_DCtx* ctx) const { ZSTD_freeDCtx(ctx); }
+    };
+
+    using CDictPtr = std::unique_ptr<ZSTD_CDict, CDictDeleter>;
+    using DDictPtr = std::unique_ptr<ZSTD_DDict, DDictDeleter>;
+
+    struct Version {
+        CDictPtr cdict;
+        DDictPtr ddict;
+    };
+
+    // Contexts are expensive to create, every thread keeps one of each.
+    static auto CCtx() -> ZSTD_CCtx* {
+        thread_local std::unique_ptr<ZSTD_CCtx, CCtxDeleter> ctx(ZSTD_createCCtx());
+        return ctx.get();
+    }
+
+    static auto DCtx() -> ZSTD_DCtx* {
+        thread_local std::unique_ptr<ZSTD_DCtx, DCtxDeleter> ctx(ZSTD_createDCtx());
+        return ctx.get();
+    }
+
+    static void StoreVersion(uint32_t version, char* out) {
+        for (size_t i = 0; i < sizeof(version); ++i) {
+            out[i] = static_cast<char>((version >> (i * 8)) & 0xFF);
+        }
+    }
+
+    static auto LoadVersion(const char* in) -> uint32_t {
+        uint32_t version = 0;
+        for (size_t i = 0; i < sizeof(version); ++i) {
+            version |= static_cast<uint32_t>(static_cast<uint8_t>(in[i])) << (i * 8);
+        }
+        return version;
+    }
+
+    int level_;
+    size_t max_value_bytes_;
+    mutable std::shared_mutex mutex_{};
+    std::map<uint32_t, Version> versions_{};
+};
+
+}  // namespace detail
+
+}  // namespace oryx
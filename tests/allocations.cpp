@@ -0,0 +1,149 @@
+#include "doctest.hpp"
+
+#include <cstdlib>
+#include <new>
+
+#include <oryx/key_value_database.hpp>
+
+#include "test_utils.hpp"
+
+// Built into its own test executable, replacing the global allocation functions affects the whole program.
+
+using namespace oryx;
+
+namespace {
+
+thread_local size_t allocations = 0;
+
+}  // namespace
+
+auto operator new(std::size_t size) -> void* {
+    ++allocations;
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace {
+
+using FixedCodec = WithNumberFormat<JsonCodec, NumberFormat::kFixedLittleEndian>;
+
+enum class Source : uint8_t { kSensor = 1, kManual = 2 };
+
+struct Sample {
+    uint64_t timestamp;
+    double value;
+    int32_t sensor;
+    Source source;
+    bool valid;
+};
+
+struct Reading {
+    std::string device;
+    int64_t timestamp;
+    double temperature;
+    std::vector<int> samples;
+    bool online;
+};
+
+}  // namespace
+
+template <>
+struct oryx::fixed_layout<Sample> : std::true_type {};
+
+static_assert(detail::is_fixed_layout_v<Sample>);
+static_assert(!detail::is_fixed_layout_v<Reading>);
+
+TEST_CASE("Encoding into a warm buffer does not allocate") {
+    const std::string text(100, 'x');
+    std::string buffer;
+    buffer.reserve(128);
+
+    const size_t before = allocations;
+    for (int i = 0; i < 100; ++i) {
+        CHECK(detail::Encode<uint64_t, FixedCodec>(i, buffer).size() == 9);
+        CHECK(detail::Encode(static_cast<double>(i) / 3, buffer).size() > 0);
+        CHECK(detail::Encode(i, buffer).size() > 0);
+        CHECK(detail::Encode(true, buffer).size() == 1);
+        CHECK(detail::Encode(text, buffer).data() == text.data());
+        CHECK(detail::Encode(std::string_view(text), buffer).data() == text.data());
+    }
+    CHECK(allocations == before);
+}
+
+TEST_CASE("Fixed layout encoding and decoding do not allocate") {
+    const Sample sample{1, 2.0, 3, Source::kSensor, true};
+    std::string buffer;
+    detail::WriteTo(sample, buffer);
+
+    const size_t before = allocations;
+    for (int i = 0; i < 100; ++i) {
+        detail::WriteTo(Sample{static_cast<uint64_t>(i), 2.0, i, Source::kSensor, true}, buffer);
+        const auto decoded = detail::Read<Sample>(buffer);
+        CHECK(decoded.has_value());
+        CHECK(decoded->sensor == i);
+    }
+    CHECK(allocations == before);
+}
+
+TEST_CASE("Json encoding of reflected structs into a warm buffer does not allocate") {
+    const Reading reading{"sensor-0042", 1718000000123, 21.375, {1, 2, 3}, true};
+    std::string buffer;
+    detail::WriteTo(reading, buffer);
+    CHECK_EQ(buffer, JsonCodec::Write(reading));
+
+    const size_t before = allocations;
+    for (int i = 0; i < 100; ++i) {
+        detail::WriteTo(reading, buffer);
+    }
+    const size_t after = allocations;
+    CHECK(after == before);
+    CHECK_EQ(detail::Read<Reading>(buffer).value().device, reading.device);
+}
+
+TEST_CASE("Json encoding of large structs grows the arena") {
+    const Reading reading{std::string(100000, 'x'), 1, 2.0, std::vector<int>(10000, 7), false};
+    std::string buffer;
+    detail::WriteTo(reading, buffer);
+    CHECK_EQ(buffer, JsonCodec::Write(reading));
+}
+
+TEST_CASE("Visiting Get of small values in the memtable does not allocate") {
+    TempDbFile file{"alloc_get.db"};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    REQUIRE(db.Put("key", std::string(1000, 'v')).ok());
+    size_t read = 0;
+    REQUIRE(db.Get("key", [&](std::string_view value) { read += value.size(); }).ok());
+
+    const size_t before = allocations;
+    bool ok = true;
+    for (int i = 0; i < 100; ++i) {
+        ok = db.Get("key", [&](std::string_view value) { read += value.size(); }).ok() && ok;
+    }
+    CHECK(allocations == before);
+    CHECK(ok);
+    CHECK(read == 101 * 1000);
+}
+
+TEST_CASE("Scratch batch is reused") {
+    const leveldb::WriteBatch* batch = nullptr;
+    {
+        detail::ScratchBatch scratch{};
+        scratch.get().Put("key", "value");
+        batch = &scratch.get();
+    }
+    {
+        detail::ScratchBatch scratch{};
+        CHECK(&scratch.get() == batch);
+        CHECK(scratch.get().ApproximateSize() < 16);
+
+        // A nested instance gets a batch of its own.
+        detail::ScratchBatch nested{};
+        CHECK(&nested.get() != batch);
+    }
+}
@@ -0,0 +1,160 @@
+#include "doctest.hpp"
+
+#include <atomic>
+#include <thread>
+
+#include <oryx/key_value_database.hpp>
+
+#include "test_utils.hpp"
+
+using namespace oryx;
+
+namespace {
+
+struct Dummy {
+    std::string prop0;
+    int prop1;
+};
+
+}  // namespace
+
+TEST_CASE("Thread pool runs tasks and drains its queue on shutdown") {
+    std::atomic<int> ran{0};
+    auto answer = std::future<int>{};
+    {
+        ThreadPool pool(2, 4);
+        CHECK(pool.size() == 2);
+        answer = pool.Async([] { return 42; });
+        for (int i = 0; i < 100; ++i) {
+            pool.Submit([&] { ++ran; });
+        }
+    }
+    CHECK(ran == 100);
+    CHECK(answer.get() == 42);
+}
+
+TEST_CASE("Concurrent async writes are coalesced") {
+    ThreadPool pool(2);
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::vector<size_t> batch_sizes;
+    std::vector<bool> syncs;
+
+    detail::WriteCoalescer writes(pool, 1024 * 1024, [&](leveldb::WriteBatch& batch, bool sync) {
+        released.wait();
+        batch_sizes.push_back(batch.ApproximateSize());
+        syncs.push_back(sync);
+        return leveldb::Status::OK();
+    });
+
+    // The first batch blocks until everything else is queued behind it.
+    std::vector<std::future<leveldb::Status>> pending;
+    pending.push_back(writes.Put("first", "value", false));
+    for (int i = 0; i < 99; ++i) {
+        pending.push_back(i % 2 == 0 ? writes.Put("key" + std::to_string(i), "value", i == 50)
+                                     : writes.Delete("key" + std::to_string(i), false));
+    }
+    release.set_value();
+
+    for (auto& write : pending) {
+        CHECK(write.get().ok());
+    }
+    REQUIRE(batch_sizes.size() <= 2);
+    CHECK(std::find(syncs.begin(), syncs.end(), true) != syncs.end());
+}
+
+TEST_CASE("Writes go through with a batch limit below the size of an empty batch") {
+    ThreadPool pool(2);
+    std::atomic<size_t> batches{0};
+    detail::WriteCoalescer writes(pool, 0, [&](leveldb::WriteBatch&, bool) {
+        ++batches;
+        return leveldb::Status::OK();
+    });
+
+    std::vector<std::future<leveldb::Status>> pending;
+    for (int i = 0; i < 10; ++i) {
+        pending.push_back(writes.Put("key" + std::to_string(i), "value", false));
+    }
+    for (auto& write : pending) {
+        CHECK(write.get().ok());
+    }
+    CHECK(batches == 10);
+}
+
+TEST_CASE("Waiters that wait for another write do not hold up the coalescer") {
+    ThreadPool pool(2);
+    std::atomic<size_t> batches{0};
+    detail::WriteCoalescer writes(pool, 0, [&](leveldb::WriteBatch&, bool) {
+        ++batches;
+        return leveldb::Status::OK();
+    });
+
+    // The batch of the nested write is drained by the other worker while the waiter blocks.
+    std::promise<leveldb::Status> nested;
+    writes.Put("first", "value", false,
+               [&](const leveldb::Status&) { nested.set_value(writes.Put("second", "value", false).get()); });
+    auto result = nested.get_future();
+    REQUIRE(result.wait_for(std::chrono::seconds(10)) == std::future_status::ready);
+    CHECK(result.get().ok());
+    CHECK(batches == 2);
+}
+
+TEST_CASE("Async operations on an opened db") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    CHECK(db.PutAsync("key", 1).get().IsInvalidArgument());
+    CHECK(db.GetAsync<int>("key").get().status.IsInvalidArgument());
+
+    db.EnableAsync({.threads = 2});
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&, t] {
+            std::vector<std::future<leveldb::Status>> pending;
+            for (int i = 0; i < 50; ++i) {
+                const auto key = "key" + std::to_string(t * 50 + i);
+                pending.push_back(db.PutAsync(key, Dummy{key, t * 50 + i}));
+            }
+            for (auto& write : pending) {
+                CHECK(write.get().ok());
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    auto read = db.GetAsync<Dummy>("key123").get();
+    REQUIRE(read.status.ok());
+    CHECK(read.value.prop1 == 123);
+
+    REQUIRE(db.DeleteAsync("key123").get().ok());
+    CHECK(db.GetAsync<Dummy>("key123").get().status.IsNotFound());
+
+    // Kept across reopening, pending writes are finished by Close.
+    auto last = db.PutAsync("last", 7);
+    db.Close();
+    REQUIRE(last.get().ok());
+    REQUIRE(db.Open(file.ToString()).ok());
+    auto reopened = db.GetAsync<int>("last").get();
+    REQUIRE(reopened.status.ok());
+    CHECK(reopened.value == 7);
+}
+
+TEST_CASE("Async writes invalidate the object cache") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    db.EnableObjectCache();
+    db.EnableAsync();
+
+    REQUIRE(db.Put("key", Dummy{"a", 1}).ok());
+    Dummy dummy{};
+    REQUIRE(db.Get("key", dummy).ok());
+
+    REQUIRE(db.PutAsync("key", Dummy{"b", 2}).get().ok());
+    REQUIRE(db.Get("key", dummy).ok());
+    CHECK(dummy.prop1 == 2);
+}
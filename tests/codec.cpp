@@ -0,0 +1,317 @@
+#include "doctest.hpp"
+
+#include <oryx/key_value_database.hpp>
+
+#include "test_utils.hpp"
+
+using namespace oryx;
+
+namespace {
+
+struct Point {
+    int x;
+    int y;
+};
+
+struct Pinned {
+    std::string name;
+};
+
+// Json with a marker in front so tests can tell which codec wrote a value.
+struct MarkedJsonCodec {
+    static constexpr char kMarker = '#';
+
+    template <typename T>
+    static auto Read(std::string_view val) -> std::optional<T> {
+        if (val.empty() || val.front() != kMarker) {
+            return std::nullopt;
+        }
+        return JsonCodec::Read<T>(val.substr(1));
+    }
+
+    template <typename T>
+    static auto Write(const T& obj) -> std::string {
+        return kMarker + JsonCodec::Write(obj);
+    }
+};
+
+}  // namespace
+
+template <>
+struct oryx::value_codec<Pinned> {
+    using type = MarkedJsonCodec;
+};
+
+TEST_CASE("Json codec is the default") {
+    CHECK(std::is_same_v<KeyValueDatabase::codec_type, JsonCodec>);
+    CHECK_EQ(detail::Write(Point{1, 2}), R"({"x":1,"y":2})");
+}
+
+TEST_CASE("Per type codec overrides the default codec") {
+    CHECK_EQ(detail::Write(Pinned{"a"}), R"(#{"name":"a"})");
+    CHECK_EQ(detail::Read<Pinned>(R"(#{"name":"a"})").value().name, "a");
+    CHECK_FALSE(detail::Read<Pinned>(R"({"name":"a"})"));
+}
+
+TEST_CASE("Per instance codec is used for reflected types") {
+    TempDbFile file{};
+    BasicKeyValueDatabase<MarkedJsonCodec> db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    REQUIRE(db.Put("point", Point{3, 4}).ok());
+    REQUIRE(db.Put("number", 7).ok());
+
+    std::string raw;
+    REQUIRE(db.handle().Get(db.DefaultReadOptions(), "point", &raw).ok());
+    CHECK_EQ(raw, R"(#{"x":3,"y":4})");
+    REQUIRE(db.handle().Get(db.DefaultReadOptions(), "number", &raw).ok());
+    CHECK_EQ(raw, "7");
+
+    Point point{};
+    REQUIRE(db.Get("point", point).ok());
+    CHECK(point.x == 3);
+    CHECK(point.y == 4);
+}
+
+#ifdef ORYX_KVDB_MSGPACK
+TEST_CASE("Msgpack codec round trip") {
+    TempDbFile file{};
+    BasicKeyValueDatabase<MsgpackCodec> db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    REQUIRE(db.Put("point", Point{3, 4}).ok());
+    Point point{};
+    REQUIRE(db.Get("point", point).ok());
+    CHECK(point.x == 3);
+    CHECK(point.y == 4);
+}
+#endif
+
+#ifdef ORYX_KVDB_CBOR
+TEST_CASE("Cbor codec round trip") {
+    TempDbFile file{};
+    BasicKeyValueDatabase<CborCodec> db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    REQUIRE(db.Put("point", Point{3, 4}).ok());
+    Point point{};
+    REQUIRE(db.Get("point", point).ok());
+    CHECK(point.x == 3);
+    CHECK(point.y == 4);
+}
+#endif
+
+namespace {
+
+using FixedCodec = WithNumberFormat<JsonCodec, NumberFormat::kFixedLittleEndian>;
+using OrderedCodec = WithNumberFormat<JsonCodec, NumberFormat::kOrderedBigEndian>;
+
+template <typename T>
+auto Ordered(T val) {
+    return detail::Write<T, OrderedCodec>(val);
+}
+
+}  // namespace
+
+TEST_CASE("Writing fixed width little endian numbers") {
+    CHECK_EQ(detail::Write<uint32_t, FixedCodec>(0x01020304), std::string("\x01\x04\x03\x02\x01", 5));
+    CHECK_EQ(detail::Write<int16_t, FixedCodec>(-2), std::string("\x01\xFE\xFF", 3));
+    CHECK_EQ(detail::Write<uint64_t, FixedCodec>(5).size(), 9);
+    CHECK_EQ(detail::Write<double, FixedCodec>(1.5).size(), 9);
+    CHECK_EQ(detail::Write<bool, FixedCodec>(true), "1");
+}
+
+TEST_CASE("Writing ordered big endian numbers") {
+    CHECK_EQ(Ordered<uint32_t>(0x01020304), std::string("\x02\x01\x02\x03\x04", 5));
+    CHECK_EQ(Ordered<int32_t>(0), std::string("\x02\x80\x00\x00\x00", 5));
+    CHECK(Ordered<int64_t>(-10) < Ordered<int64_t>(-9));
+    CHECK(Ordered<int64_t>(-1) < Ordered<int64_t>(0));
+    CHECK(Ordered<int64_t>(9) < Ordered<int64_t>(10));
+    CHECK(Ordered<double>(-2.5) < Ordered<double>(-1.0));
+    CHECK(Ordered<double>(-1.0) < Ordered<double>(0.0));
+    CHECK(Ordered<double>(0.0) < Ordered<double>(1e-9));
+    CHECK(Ordered<double>(1e-9) < Ordered<double>(3.0));
+    CHECK(Ordered<float>(-1.0f) < Ordered<float>(2.0f));
+}
+
+TEST_CASE("Reading fixed width numbers") {
+    CHECK(detail::Read<uint64_t>(detail::Write<uint64_t, FixedCodec>(18446744073709551615ULL)).value() ==
+          18446744073709551615ULL);
+    CHECK(detail::Read<int>(detail::Write<int, FixedCodec>(-5)).value() == -5);
+    CHECK(detail::Read<int>(Ordered<int>(-5)).value() == -5);
+    CHECK(detail::Read<double>(detail::Write<double, FixedCodec>(1.256)).value() == 1.256);
+    CHECK(detail::Read<double>(Ordered<double>(-1.256)).value() == -1.256);
+    CHECK(detail::Read<float>(Ordered<float>(1e-9f)).value() == 1e-9f);
+    CHECK(detail::Read<int8_t>(Ordered<int8_t>(-128)).value() == -128);
+
+    // Text written before switching formats is still readable.
+    CHECK(detail::Read<int, FixedCodec>("-5").value() == -5);
+    CHECK_FALSE(detail::Read<int>(std::string("\x01\x00\x00", 3)));
+    CHECK_FALSE(detail::Read<int>(std::string("\x03\x00\x00\x00\x00", 5)));
+}
+
+TEST_CASE("Fixed width numbers on opened db") {
+    TempDbFile file{};
+    BasicKeyValueDatabase<OrderedCodec> db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    REQUIRE(db.handle().Put(db.DefaultWriteOptions(), "legacy", "42").ok());
+    REQUIRE(db.Put("fixed", int64_t{-42}).ok());
+
+    int64_t val = 0;
+    REQUIRE(db.Get("legacy", val).ok());
+    CHECK(val == 42);
+    REQUIRE(db.Get("fixed", val).ok());
+    CHECK(val == -42);
+}
+
+TEST_CASE("Scratch buffer is reused") {
+    const char* data = nullptr;
+    {
+        detail::ScratchBuffer buffer{};
+        detail::WriteTo(Point{1, 2}, buffer.get());
+        data = buffer.get().data();
+        CHECK_EQ(buffer.get(), R"({"x":1,"y":2})");
+    }
+    {
+        detail::ScratchBuffer buffer{};
+        detail::WriteTo(int64_t{5}, buffer.get());
+        CHECK(buffer.get().data() == data);
+        CHECK_EQ(buffer.get(), "5");
+    }
+}
+
+TEST_CASE("String view values can be put") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    REQUIRE(db.Put("myKey", std::string_view("hello")).ok());
+
+    std::string val;
+    REQUIRE(db.Get("myKey", val).ok());
+    CHECK(val == "hello");
+}
+
+namespace {
+
+enum class Source : uint8_t { kSensor = 1, kManual = 2 };
+
+struct Sample {
+    uint64_t timestamp;
+    double value;
+    int32_t sensor;
+    Source source;
+    bool valid;
+};
+
+struct Packed {
+    uint32_t a;
+    int32_t b;
+    float c;
+};
+
+struct Renamed {
+    uint32_t x;
+    int32_t b;
+    float c;
+};
+
+struct WithName {
+    std::string name;
+    int value;
+};
+
+struct WithArray {
+    int values[3];
+};
+
+}  // namespace
+
+template <>
+struct oryx::fixed_layout<Sample> : std::true_type {};
+template <>
+struct oryx::fixed_layout<Packed> : std::true_type {};
+template <>
+struct oryx::fixed_layout<Renamed> : std::true_type {};
+template <>
+struct oryx::fixed_layout<WithArray> : std::true_type {};
+template <>
+struct oryx::fixed_layout<std::array<int, 3>> : std::true_type {};
+
+static_assert(detail::is_fixed_layout_v<Sample>);
+static_assert(detail::is_fixed_layout_v<Packed>);
+static_assert(!detail::is_fixed_layout_v<Point>);
+static_assert(!detail::is_fixed_layout_v<Pinned>);
+static_assert(!detail::is_fixed_layout_v<WithName>);
+static_assert(!detail::is_fixed_layout_v<WithArray>);
+static_assert(!detail::is_fixed_layout_v<std::array<int, 3>>);
+static_assert(detail::fixed_fields_t<Sample>::kSize == 22);
+static_assert(detail::fixed_fields_t<Packed>::kHash != detail::fixed_fields_t<Renamed>::kHash);
+
+TEST_CASE("Fixed layout structs are stored packed") {
+    const std::string packed = detail::Write(Packed{1, -2, 0.5f});
+    REQUIRE(packed.size() == detail::kFixedLayoutHeaderSize + 12);
+    CHECK(packed.front() == '\x03');
+    CHECK(packed.substr(detail::kFixedLayoutHeaderSize, 8) == std::string("\x01\x00\x00\x00\xFE\xFF\xFF\xFF", 8));
+
+    const auto read = detail::Read<Packed>(packed);
+    REQUIRE(read.has_value());
+    CHECK(read->a == 1);
+    CHECK(read->b == -2);
+    CHECK(read->c == 0.5f);
+
+    const Sample sample{1700000000123, -1.256, 7, Source::kManual, true};
+    const std::string encoded = detail::Write(sample);
+    CHECK(encoded.size() == detail::kFixedLayoutHeaderSize + 22);
+    const auto decoded = detail::Read<Sample>(encoded);
+    REQUIRE(decoded.has_value());
+    CHECK(decoded->timestamp == sample.timestamp);
+    CHECK(decoded->value == sample.value);
+    CHECK(decoded->sensor == sample.sensor);
+    CHECK(decoded->source == sample.source);
+    CHECK(decoded->valid);
+}
+
+TEST_CASE("Arrays stay on the codec") {
+    CHECK_EQ(detail::Write(std::array<int, 3>{1, 2, 3}), "[1,2,3]");
+    const auto read = detail::Read<std::array<int, 3>>("[1,2,3]");
+    REQUIRE(read.has_value());
+    CHECK((*read)[2] == 3);
+}
+
+TEST_CASE("Fixed layout rejects other layouts and falls back to the codec") {
+    const std::string packed = detail::Write(Packed{1, 2, 3.0f});
+    CHECK_FALSE(detail::Read<Renamed>(packed));
+    CHECK_FALSE(detail::Read<Packed>(packed.substr(0, packed.size() - 1)));
+
+    std::string bad_bool = detail::Write(Sample{1, 2.0, 3, Source::kSensor, false});
+    bad_bool.back() = '\x02';
+    CHECK_FALSE(detail::Read<Sample>(bad_bool));
+
+    // Values written as json before the type had a fixed layout.
+    const auto legacy = detail::Read<Packed>(R"({"a":4,"b":5,"c":6.5})");
+    REQUIRE(legacy.has_value());
+    CHECK(legacy->a == 4);
+    CHECK(legacy->c == 6.5f);
+}
+
+TEST_CASE("Fixed layout structs on opened db") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    REQUIRE(db.handle().Put(db.DefaultWriteOptions(), "legacy", R"({"a":1,"b":2,"c":3})").ok());
+    REQUIRE(db.Put("packed", Packed{4, 5, 6.0f}).ok());
+
+    Packed packed{};
+    REQUIRE(db.Get("legacy", packed).ok());
+    CHECK(packed.b == 2);
+    REQUIRE(db.Get("packed", packed).ok());
+    CHECK(packed.b == 5);
+
+    // Rewriting a legacy value converts it.
+    REQUIRE(db.Put("legacy", Packed{1, 2, 3.0f}).ok());
+    std::string raw;
+    REQUIRE(db.handle().Get(db.DefaultReadOptions(), "legacy", &raw).ok());
+    CHECK(raw.front() == '\x03');
+}
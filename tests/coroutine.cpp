@@ -0,0 +1,211 @@
+#include "doctest.hpp"
+
+#include <coroutine>
+#include <deque>
+#include <exception>
+#include <thread>
+
+#include <oryx/key_value_database.hpp>
+
+#include "test_utils.hpp"
+
+using namespace oryx;
+
+namespace {
+
+struct Dummy {
+    std::string prop0;
+    int prop1;
+};
+
+// Eagerly started coroutine that only reports whether it ran to the end.
+struct Task {
+    struct promise_type {
+        auto get_return_object() -> Task { return Task{}; }
+        auto initial_suspend() noexcept -> std::suspend_never { return {}; }
+        auto final_suspend() noexcept -> std::suspend_never { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+// Event loop stand in, runs posted tasks on the thread calling RunUntil.
+class QueueExecutor {
+public:
+    void Submit(std::function<void()> task) {
+        // Notifies under the lock, the loop may return and be destroyed as soon as the task is visible.
+        std::lock_guard lock(mutex_);
+        tasks_.push_back(std::move(task));
+        cv_.notify_one();
+    }
+
+    void RunUntil(const std::atomic<bool>& done) {
+        while (!done) {
+            std::unique_lock lock(mutex_);
+            if (!cv_.wait_for(lock, std::chrono::seconds(10), [this] { return !tasks_.empty(); })) {
+                FAIL("Nothing was resumed");
+            }
+            auto task = std::move(tasks_.front());
+            tasks_.pop_front();
+            lock.unlock();
+            task();
+        }
+    }
+
+private:
+    std::mutex mutex_{};
+    std::condition_variable cv_{};
+    std::deque<std::function<void()>> tasks_{};
+};
+
+// Coroutines take their state as parameters, captures of a lambda coroutine die with the lambda. Results are
+// awaited into locals, gcc 12 mishandles temporaries inside co_await expressions.
+auto RoundTrip(KeyValueDatabase& db, QueueExecutor& loop, std::atomic<bool>& done) -> Task {
+    const auto loop_thread = std::this_thread::get_id();
+    const Dummy dummy{"a", 1};
+
+    const leveldb::Status put = co_await db.CoPut("key", dummy, loop);
+    CHECK(put.ok());
+    CHECK(std::this_thread::get_id() == loop_thread);
+
+    const GetResult<Dummy> read = co_await db.CoGet<Dummy>("key", loop);
+    CHECK(std::this_thread::get_id() == loop_thread);
+    CHECK(read.status.ok());
+    CHECK(read.value.prop1 == 1);
+
+    const leveldb::Status deleted = co_await db.CoDelete("key", loop);
+    CHECK(deleted.ok());
+    const GetResult<Dummy> missing = co_await db.CoGet<Dummy>("key", loop);
+    CHECK(missing.status.IsNotFound());
+    done = true;
+}
+
+auto WithoutExecutor(KeyValueDatabase& db, std::atomic<bool>& done) -> Task {
+    const leveldb::Status disabled = co_await db.CoPut("key", 1);
+    CHECK(disabled.IsInvalidArgument());
+
+    db.EnableAsync();
+    const leveldb::Status put = co_await db.CoPut("key", 2);
+    CHECK(put.ok());
+    const GetResult<int> read = co_await db.CoGet<int>("key");
+    CHECK(read.value == 2);
+    done = true;
+}
+
+auto PutMany(KeyValueDatabase& db, std::string prefix, std::atomic<int>& done) -> Task {
+    for (int i = 0; i < 20; ++i) {
+        const leveldb::Status put = co_await db.CoPut(prefix + std::to_string(i), i);
+        CHECK(put.ok());
+        CHECK(db.Update<int>("counter", [](int& counter) { ++counter; }).ok());
+    }
+    ++done;
+}
+
+static_assert(Executor<ThreadPool>);
+static_assert(Executor<InlineExecutor>);
+static_assert(Executor<QueueExecutor>);
+
+}  // namespace
+
+TEST_CASE("Coroutines resume on the executor they passed") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    db.EnableAsync({.threads = 2});
+
+    QueueExecutor loop{};
+    std::atomic<bool> done{false};
+    RoundTrip(db, loop, done);
+
+    loop.RunUntil(done);
+}
+
+TEST_CASE("Coroutines without an executor resume on a worker") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    std::atomic<bool> done{false};
+    WithoutExecutor(db, done);
+
+    for (int i = 0; i < 1000 && !done; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK(done);
+}
+
+TEST_CASE("Coroutines without an executor keep writing with a small batch limit") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    db.EnableAsync({.threads = 1, .max_batch_bytes = 1});
+
+    std::atomic<int> done{0};
+    PutMany(db, "a", done);
+    PutMany(db, "b", done);
+
+    for (int i = 0; i < 1000 && done < 2; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    REQUIRE(done == 2);
+    int counter = 0;
+    REQUIRE(db.Get("counter", counter).ok());
+    CHECK(counter == 40);
+    int last = 0;
+    REQUIRE(db.Get("b19", last).ok());
+    CHECK(last == 19);
+}
+
+TEST_CASE("Reads submitted before a worker picks them up are read together") {
+    ThreadPool pool(1);
+    std::promise<void> release;
+    pool.Submit([released = release.get_future().share()] { released.wait(); });
+
+    std::vector<size_t> batches;
+    detail::ReadCoalescer reads(pool, [&](std::vector<detail::PendingRead>& pending) {
+        batches.push_back(pending.size());
+        for (auto& read : pending) {
+            read.done(leveldb::Status::OK(), read.key);
+        }
+    });
+
+    std::atomic<int> answered{0};
+    for (int i = 0; i < 10; ++i) {
+        auto done = [&, i](const leveldb::Status& status, std::string_view val) {
+            CHECK(status.ok());
+            CHECK(val == std::to_string(i));
+            ++answered;
+        };
+        reads.Get(detail::PendingRead{std::to_string(i), {}, done});
+    }
+    release.set_value();
+    pool.Shutdown();
+
+    CHECK(answered == 10);
+    CHECK(batches == std::vector<size_t>{10});
+}
+
+TEST_CASE("Async reads with different keys and options are all answered") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(db.Put("key" + std::to_string(i), i).ok());
+    }
+    db.EnableAsync({.threads = 1});
+
+    std::vector<std::future<GetResult<int>>> reads;
+    for (int i = 0; i < 120; ++i) {
+        reads.push_back(db.GetAsync<int>("key" + std::to_string(119 - i),
+                                         i % 2 == 0 ? db.DefaultReadOptions() : db.BulkReadOptions()));
+    }
+    for (int i = 0; i < 120; ++i) {
+        auto read = reads[i].get();
+        if (119 - i < 100) {
+            REQUIRE(read.status.ok());
+            CHECK(read.value == 119 - i);
+        } else {
+            CHECK(read.status.IsNotFound());
+        }
+    }
+}
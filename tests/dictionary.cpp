@@ -0,0 +1,183 @@
+#include "doctest.hpp"
+
+#ifdef ORYX_KVDB_ZSTD
+
+#include <oryx/key_value_database.hpp>
+
+#include "test_utils.hpp"
+
+using namespace oryx;
+
+namespace {
+
+struct Order {
+    std::string customer;
+    std::string status;
+    std::string currency;
+    int quantity;
+    double price;
+};
+
+auto MakeOrder(int i) -> Order {
+    return Order{"customer-" + std::to_string(i % 97), i % 3 == 0 ? "shipped" : "pending", "EUR", i, i * 0.25};
+}
+
+auto RawSize(KeyValueDatabase& db, const std::string& key) -> size_t {
+    std::string raw;
+    REQUIRE(db.handle().Get(db.DefaultReadOptions(), key, &raw).ok());
+    return raw.size();
+}
+
+void Fill(KeyValueDatabase& db, const std::string& prefix, int count) {
+    for (int i = 0; i < count; ++i) {
+        REQUIRE(db.Put(prefix + std::to_string(i), MakeOrder(i)).ok());
+    }
+}
+
+}  // namespace
+
+TEST_CASE("Dictionary keys sort by version") {
+    CHECK(detail::DictionaryKey("orders", 1) == std::string("\0kvdb.dict.orders/00000001", 26));
+    CHECK(detail::DictionaryKey("orders", 9) < detail::DictionaryKey("orders", 16));
+    CHECK(detail::DictionaryVersion(detail::DictionaryKey("orders", 16), detail::DictionaryKeyPrefix("orders")) == 16);
+    CHECK_FALSE(detail::DictionaryVersion("orders/1", detail::DictionaryKeyPrefix("orders")));
+}
+
+TEST_CASE("Values are compressed with a trained dictionary") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    Fill(db, "order:", 2000);
+    REQUIRE(db.RegisterDictionary<Order>("orders").ok());
+    const size_t plain_size = RawSize(db, "order:1");
+
+    // Nothing trained yet, values are stored as is.
+    REQUIRE(db.Put("order:1", MakeOrder(1)).ok());
+    CHECK(RawSize(db, "order:1") == plain_size);
+
+    REQUIRE(db.TrainDictionary("orders", "order:").ok());
+    REQUIRE(db.Put("order:1", MakeOrder(1)).ok());
+    CHECK(RawSize(db, "order:1") < plain_size);
+
+    Order order{};
+    REQUIRE(db.Get("order:1", order).ok());
+    CHECK(order.customer == "customer-1");
+    REQUIRE(db.Get("order:2", order).ok());
+    CHECK(order.quantity == 2);
+
+    std::string status;
+    REQUIRE(db.GetField<&Order::status>("order:1", status).ok());
+    CHECK(status == "pending");
+
+    size_t count = 0;
+    for (const auto& entry : db.ScanPrefix<Order>("order:")) {
+        CHECK(entry.value().has_value());
+        ++count;
+    }
+    CHECK(count == 2000);
+
+    const std::vector<leveldb::Slice> keys{"order:1", "order:2"};
+    for (const auto& result : db.MultiGet<Order>(keys)) {
+        CHECK(result.status.ok());
+    }
+}
+
+TEST_CASE("Older dictionary versions stay readable after retraining and reopening") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    Fill(db, "order:", 2000);
+    REQUIRE(db.RegisterDictionary<Order>("orders").ok());
+    REQUIRE(db.TrainDictionary("orders", "order:").ok());
+    REQUIRE(db.Put("order:1", MakeOrder(1)).ok());
+    REQUIRE(db.TrainDictionary("orders", "order:").ok());
+    REQUIRE(db.Put("order:2", MakeOrder(2)).ok());
+
+    std::string raw1;
+    std::string raw2;
+    REQUIRE(db.handle().Get(db.DefaultReadOptions(), "order:1", &raw1).ok());
+    REQUIRE(db.handle().Get(db.DefaultReadOptions(), "order:2", &raw2).ok());
+    CHECK(raw1.substr(0, 5) == std::string("\x04\x01\x00\x00\x00", 5));
+    CHECK(raw2.substr(0, 5) == std::string("\x04\x02\x00\x00\x00", 5));
+
+    db.Close();
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    // Compressed values can not be read before the dictionary is registered again.
+    Order order{};
+    CHECK_FALSE(db.Get("order:1", order).ok());
+
+    REQUIRE(db.RegisterDictionary<Order>("orders").ok());
+    REQUIRE(db.Get("order:1", order).ok());
+    CHECK(order.quantity == 1);
+    REQUIRE(db.Get("order:2", order).ok());
+    CHECK(order.quantity == 2);
+}
+
+TEST_CASE("Scans over the whole keyspace skip stored dictionaries") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    Fill(db, "order:", 2000);
+    REQUIRE(db.RegisterDictionary<Order>("orders").ok());
+    REQUIRE(db.TrainDictionary("orders", "order:").ok());
+
+    size_t count = 0;
+    for (const auto& entry : db.Scan<Order>("", "")) {
+        CHECK(entry.key().starts_with("order:"));
+        CHECK(entry.value().has_value());
+        ++count;
+    }
+    CHECK(count == 2000);
+
+    count = 0;
+    for (const auto& entry : db.ScanPrefix<Order>("")) {
+        CHECK(entry.value().has_value());
+        ++count;
+    }
+    CHECK(count == 2000);
+}
+
+TEST_CASE("Compressed values claiming an oversized content are rejected") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    Fill(db, "order:", 2000);
+    DictionaryOptions opts{};
+    opts.max_value_bytes = 1024;
+    REQUIRE(db.RegisterDictionary<Order>("orders", opts).ok());
+    REQUIRE(db.TrainDictionary("orders", "order:", opts).ok());
+
+    // Magic number, a header with an 8 byte content size and a window, then a claimed 1 GiB of content, as a
+    // corrupted value could have.
+    const std::string frame("\x28\xB5\x2F\xFD\xC0\x00\x00\x00\x00\x40\x00\x00\x00\x00", 14);
+    REQUIRE(ZSTD_getFrameContentSize(frame.data(), frame.size()) == 1ULL << 30);
+
+    const std::string raw = std::string("\x04\x01\x00\x00\x00", 5) + frame;
+    REQUIRE(db.handle().Put(db.DefaultWriteOptions(), "order:1", raw).ok());
+    Order order{};
+    CHECK(db.Get("order:1", order).IsIOError());
+
+    // Values above the limit are stored as is.
+    Order large = MakeOrder(1);
+    large.customer = std::string(2048, 'c');
+    REQUIRE(db.Put("order:2", large).ok());
+    CHECK(RawSize(db, "order:2") > 2048);
+    REQUIRE(db.Get("order:2", order).ok());
+    CHECK(order.customer == large.customer);
+}
+
+TEST_CASE("Training needs enough samples") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    Fill(db, "order:", 3);
+    CHECK(db.TrainDictionary("orders", "order:").IsInvalidArgument());
+}
+
+#endif
@@ -0,0 +1,137 @@
+#include "doctest.hpp"
+
+#include <oryx/key_value_database.hpp>
+
+#include "test_utils.hpp"
+
+using namespace oryx;
+
+namespace {
+
+struct Nested {
+    std::vector<int> values;
+    std::string note;
+};
+
+struct Document {
+    std::string name;
+    Nested nested;
+    std::optional<std::string> comment;
+    int version;
+    std::string status;
+};
+
+struct Packed {
+    uint32_t a;
+    double b;
+    bool c;
+};
+
+}  // namespace
+
+template <>
+struct oryx::fixed_layout<Packed> : std::true_type {};
+
+TEST_CASE("Json members are found without parsing the others") {
+    const std::string json = R"( { "name" : "a\"}{,", "nested":{"values":[1,[2],{"x":"]"}],"note":"}"},"version": 7 })";
+    CHECK(detail::FindJsonMember(json, "name") == R"("a\"}{,")");
+    CHECK(detail::FindJsonMember(json, "nested") == R"({"values":[1,[2],{"x":"]"}],"note":"}"})");
+    CHECK(detail::FindJsonMember(json, "version") == "7");
+    CHECK_FALSE(detail::FindJsonMember(json, "values"));
+    CHECK_FALSE(detail::FindJsonMember(json, "missing"));
+    CHECK_FALSE(detail::FindJsonMember("[1,2]", "name"));
+    CHECK_FALSE(detail::FindJsonMember(R"({"name":"unterminated)", "name"));
+}
+
+TEST_CASE("Field names and offsets are resolved from member pointers") {
+    CHECK(detail::FieldOf<&Document::name>().name == "name");
+    CHECK(detail::FieldOf<&Document::version>().name == "version");
+    CHECK(detail::FieldOf<&Packed::a>().offset == 0);
+    CHECK(detail::FieldOf<&Packed::b>().offset == 4);
+    CHECK(detail::FieldOf<&Packed::c>().offset == 12);
+}
+
+TEST_CASE("GetField reads a single member") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    REQUIRE(db.Put("doc", Document{"doc", {{1, 2, 3}, "n"}, std::nullopt, 3, "active"}).ok());
+    REQUIRE(db.Put("packed", Packed{9, -2.5, true}).ok());
+
+    int version = 0;
+    REQUIRE(db.GetField<&Document::version>("doc", version).ok());
+    CHECK(version == 3);
+
+    std::string status;
+    REQUIRE(db.GetField<&Document::status>("doc", status).ok());
+    CHECK(status == "active");
+
+    Nested nested{};
+    REQUIRE(db.GetField<&Document::nested>("doc", nested).ok());
+    CHECK(nested.values == std::vector<int>{1, 2, 3});
+
+    // Absent optional members fall back to decoding the object.
+    std::optional<std::string> comment = "x";
+    REQUIRE(db.GetField<&Document::comment>("doc", comment).ok());
+    CHECK_FALSE(comment.has_value());
+
+    double b = 0;
+    REQUIRE(db.GetField<&Packed::b>("packed", b).ok());
+    CHECK(b == -2.5);
+    bool c = false;
+    REQUIRE(db.GetField<&Packed::c>("packed", c).ok());
+    CHECK(c);
+
+    CHECK(db.GetField<&Document::version>("missing", version).IsNotFound());
+}
+
+TEST_CASE("GetField does not decode other members") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    // nested has the wrong type, so only a projection can read this value.
+    REQUIRE(db.handle()
+                .Put(db.DefaultWriteOptions(), "doc",
+                     R"({"name":"doc","nested":"not an object","version":5,"status":"ok"})")
+                .ok());
+
+    Document doc{};
+    CHECK_FALSE(db.Get("doc", doc).ok());
+
+    int version = 0;
+    REQUIRE(db.GetField<&Document::version>("doc", version).ok());
+    CHECK(version == 5);
+    CHECK_FALSE(db.GetField<&Document::nested>("doc", doc.nested).ok());
+}
+
+#ifdef ORYX_KVDB_MSGPACK
+TEST_CASE("GetField decodes the object with other codecs") {
+    TempDbFile file{};
+    BasicKeyValueDatabase<MsgpackCodec> db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    REQUIRE(db.Put("doc", Document{"doc", {}, std::nullopt, 4, "a"}).ok());
+    int version = 0;
+    REQUIRE(db.GetField<&Document::version>("doc", version).ok());
+    CHECK(version == 4);
+}
+#endif
+
+TEST_CASE("GetField uses cached objects") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    db.EnableObjectCache();
+
+    REQUIRE(db.Put("doc", Document{"doc", {}, std::nullopt, 1, "a"}).ok());
+    Document doc{};
+    REQUIRE(db.Get("doc", doc).ok());
+
+    // Written around the cache so only the cached object has version 1.
+    REQUIRE(db.handle().Put(db.DefaultWriteOptions(), "doc", R"({"version":2})").ok());
+    int version = 0;
+    REQUIRE(db.GetField<&Document::version>("doc", version).ok());
+    CHECK(version == 1);
+}
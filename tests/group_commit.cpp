@@ -0,0 +1,70 @@
+#include "doctest.hpp"
+
+#include <chrono>
+
+#include <oryx/key_value_database.hpp>
+
+#include "test_utils.hpp"
+
+using namespace oryx;
+using namespace std::chrono_literals;
+
+TEST_CASE("Durable is ready in sync mode") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    REQUIRE(db.durability() == Durability::kSync);
+
+    REQUIRE(db.Put("myKey", 5).ok());
+    auto durable = db.Durable();
+    REQUIRE(durable.wait_for(0s) == std::future_status::ready);
+    CHECK(durable.get().ok());
+}
+
+TEST_CASE("Group commit syncs on interval") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    db.SetDurability(Durability::kGroupCommit, {.interval = 5ms});
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(db.Put("myKey" + std::to_string(i), i).ok());
+    }
+    auto durable = db.Durable();
+    REQUIRE(durable.wait_for(5s) == std::future_status::ready);
+    CHECK(durable.get().ok());
+
+    int myVal = 0;
+    REQUIRE(db.Get("myKey42", myVal).ok());
+    CHECK(myVal == 42);
+}
+
+TEST_CASE("Group commit syncs on pending bytes") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    db.SetDurability(Durability::kGroupCommit, {.interval = 1h, .max_pending_bytes = 64});
+
+    REQUIRE(db.Put("myKey", std::string(128, 'x')).ok());
+    auto durable = db.Durable();
+    REQUIRE(durable.wait_for(5s) == std::future_status::ready);
+    CHECK(durable.get().ok());
+}
+
+TEST_CASE("Group commit persists across reopen") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    db.SetDurability(Durability::kGroupCommit, {.interval = 1h});
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    REQUIRE(db.Put("myKey", 5).ok());
+    REQUIRE(db.Delete("myKey").ok());
+    REQUIRE(db.Put("myKey", 6).ok());
+    db.Close();
+
+    REQUIRE(db.Open(file.ToString()).ok());
+    CHECK(db.durability() == Durability::kGroupCommit);
+    int myVal = 0;
+    REQUIRE(db.Get("myKey", myVal).ok());
+    CHECK(myVal == 6);
+}
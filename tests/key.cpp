@@ -0,0 +1,106 @@
+#include "doctest.hpp"
+
+#include <oryx/key.hpp>
+
+#include "test_utils.hpp"
+
+using namespace oryx;
+
+namespace {
+
+struct Dummy {
+    std::string prop0;
+    int prop1;
+};
+
+enum class Kind : int8_t { kLow = -1, kMid = 0, kHigh = 1 };
+
+}  // namespace
+
+static_assert(std::is_same_v<decltype(Key("user", 1)), Key<std::string_view, int>>);
+static_assert(std::is_same_v<Key<std::string_view, int>::decoded_type, std::tuple<std::string, int>>);
+
+TEST_CASE("Key orders numbers like their values") {
+    CHECK(Key(uint64_t{9}) < Key(uint64_t{10}));
+    CHECK(Key(uint64_t{255}) < Key(uint64_t{256}));
+    CHECK(Key(int32_t{-10}) < Key(int32_t{-9}));
+    CHECK(Key(int32_t{-1}) < Key(int32_t{0}));
+    CHECK(Key(-1.5) < Key(-0.5));
+    CHECK(Key(0.5) < Key(2.0));
+    CHECK(Key(Kind::kLow) < Key(Kind::kMid));
+    CHECK(Key(Kind::kMid) < Key(Kind::kHigh));
+    CHECK(Key(std::chrono::seconds(-5)) < Key(std::chrono::seconds(3)));
+}
+
+TEST_CASE("Key orders strings before their extensions") {
+    using namespace std::string_view_literals;
+    CHECK(Key("a"sv) < Key("a\0"sv));
+    CHECK(Key("a\0"sv) < Key("a\0\0"sv));
+    CHECK(Key("a\0\0"sv) < Key("ab"sv));
+    CHECK(Key("a", 2) < Key("ab", 1));
+    CHECK(Key("a", 1) < Key("a", 2));
+}
+
+TEST_CASE("Key of leading parts is a prefix") {
+    const Key prefix("user", uint64_t{42});
+    const Key full("user", uint64_t{42}, std::string("name"));
+    CHECK(full.bytes().starts_with(prefix.bytes()));
+    CHECK_FALSE(Key("user", uint64_t{420}).bytes().starts_with(prefix.bytes()));
+}
+
+TEST_CASE("Key round trips its parts") {
+    using namespace std::string_view_literals;
+    const auto now = std::chrono::time_point_cast<std::chrono::microseconds>(std::chrono::system_clock::now());
+    const Key key("we\0ird"sv, int16_t{-3}, true, Kind::kHigh, now, 1.25f);
+
+    const auto decoded = decltype(key)::Decode(key.bytes());
+    REQUIRE(decoded.has_value());
+    CHECK(std::get<0>(*decoded) == "we\0ird"sv);
+    CHECK(std::get<1>(*decoded) == -3);
+    CHECK(std::get<2>(*decoded));
+    CHECK(std::get<3>(*decoded) == Kind::kHigh);
+    CHECK(std::get<4>(*decoded) == now);
+    CHECK(std::get<5>(*decoded) == 1.25f);
+}
+
+TEST_CASE("Key rejects malformed bytes") {
+    const Key key("user", uint64_t{1});
+    using Decoder = Key<std::string_view, uint64_t>;
+    CHECK_FALSE(Decoder::Decode(key.bytes().substr(0, key.bytes().size() - 1)).has_value());
+    CHECK_FALSE(Decoder::Decode(key.bytes() + "x").has_value());
+    CHECK_FALSE(Decoder::Decode("user").has_value());
+    CHECK_FALSE(Key<bool>::Decode("\x02").has_value());
+}
+
+TEST_CASE("Key can be used with the database") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    for (uint64_t id : {1, 9, 10, 11, 100}) {
+        REQUIRE(db.Put(Key("user", id), Dummy{"user", static_cast<int>(id)}).ok());
+    }
+    REQUIRE(db.Put(Key("users", uint64_t{5}), Dummy{"users", 5}).ok());
+
+    Dummy dummy{};
+    REQUIRE(db.Get(Key("user", uint64_t{10}), dummy).ok());
+    CHECK(dummy.prop1 == 10);
+
+    std::vector<uint64_t> ids;
+    for (const auto& entry : db.Scan<Dummy>(Key("user", uint64_t{9}), Key("user", uint64_t{100}))) {
+        const auto decoded = Key<std::string_view, uint64_t>::Decode(entry.key());
+        REQUIRE(decoded.has_value());
+        ids.push_back(std::get<1>(*decoded));
+    }
+    CHECK(ids == std::vector<uint64_t>{9, 10, 11});
+
+    size_t count = 0;
+    for (const auto& entry : db.ScanPrefix<Dummy>(Key("user"))) {
+        CHECK(entry.value()->prop0 == "user");
+        ++count;
+    }
+    CHECK(count == 5);
+
+    REQUIRE(db.Delete(Key("user", uint64_t{1})).ok());
+    CHECK(db.Get(Key("user", uint64_t{1}), dummy).IsNotFound());
+}
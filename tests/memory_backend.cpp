@@ -0,0 +1,174 @@
+#include "doctest.hpp"
+
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <oryx/key_value_database.hpp>
+#include <oryx/sharded_key_value_database.hpp>
+
+#include "test_utils.hpp"
+
+using namespace oryx;
+
+namespace {
+
+struct Dummy {
+    std::string prop0;
+    int prop1;
+};
+
+auto Key(int i) -> std::string {
+    char key[16];
+    std::snprintf(key, sizeof(key), "item:%03d", i);
+    return key;
+}
+
+}  // namespace
+
+TEST_CASE("Memory backend reads, writes and updates typed values") {
+    MemoryKeyValueDatabase db{};
+    REQUIRE(db.Open("unused").ok());
+
+    REQUIRE(db.Put("myKey", Dummy{"a", 1}).ok());
+    Dummy val{};
+    REQUIRE(db.Get("myKey", val).ok());
+    CHECK(val.prop0 == "a");
+    CHECK(val.prop1 == 1);
+
+    REQUIRE(db.Update<Dummy>("myKey", [](Dummy& dummy) { ++dummy.prop1; }).ok());
+    int prop1 = 0;
+    REQUIRE(db.GetField<&Dummy::prop1>("myKey", prop1).ok());
+    CHECK(prop1 == 2);
+
+    REQUIRE(db.Delete("myKey").ok());
+    CHECK(db.Get("myKey", val).IsNotFound());
+
+    // Nothing survives a close.
+    REQUIRE(db.Put("myKey", Dummy{"b", 3}).ok());
+    db.Close();
+    REQUIRE(db.Open("unused").ok());
+    CHECK(db.Get("myKey", val).IsNotFound());
+}
+
+TEST_CASE("Memory backend scans keys of all stripes in order") {
+    MemoryKeyValueDatabase db{};
+    REQUIRE(db.Open("unused").ok());
+
+    MemoryKeyValueDatabase::write_batch_type batch{};
+    for (int i = 99; i >= 0; --i) {
+        batch.Put(Key(i), i);
+    }
+    batch.Put("other", -1);
+    REQUIRE(db.Write(batch).ok());
+
+    int expected = 0;
+    for (const auto& entry : db.ScanPrefix<int>("item:")) {
+        CHECK(entry.key() == Key(expected));
+        CHECK(entry.value() == expected);
+        ++expected;
+    }
+    CHECK(expected == 100);
+
+    std::vector<int> values;
+    for (const auto& entry : db.Scan<int>(Key(10), Key(13))) {
+        values.push_back(entry.value().value());
+    }
+    CHECK(values == std::vector<int>{10, 11, 12});
+
+    std::unique_ptr<leveldb::Iterator> it(db.backend().NewIterator(leveldb::ReadOptions{}));
+    it->SeekToLast();
+    REQUIRE(it->Valid());
+    CHECK(it->key().ToString() == "other");
+    it->Prev();
+    REQUIRE(it->Valid());
+    CHECK(it->key().ToString() == Key(99));
+    it->Seek(Key(0));
+    it->Prev();
+    CHECK_FALSE(it->Valid());
+}
+
+TEST_CASE("Memory backend iterates beyond a batch in both directions") {
+    MemoryKeyValueDatabase db{};
+    REQUIRE(db.Open("unused").ok());
+
+    constexpr int kEntries = 5000;
+    MemoryKeyValueDatabase::write_batch_type batch{};
+    for (int i = 0; i < kEntries; ++i) {
+        batch.Put(Key(i), i);
+    }
+    REQUIRE(db.Write(batch).ok());
+
+    std::unique_ptr<leveldb::Iterator> it(db.backend().NewIterator(leveldb::ReadOptions{}));
+    int expected = 0;
+    for (it->SeekToFirst(); it->Valid(); it->Next()) {
+        CHECK(it->key().ToString() == Key(expected));
+        ++expected;
+    }
+    CHECK(expected == kEntries);
+
+    for (it->SeekToLast(); it->Valid(); it->Prev()) {
+        --expected;
+        CHECK(it->key().ToString() == Key(expected));
+    }
+    CHECK(expected == 0);
+
+    // Changing direction continues from the current key.
+    it->Seek(Key(2500));
+    it->Next();
+    it->Prev();
+    it->Prev();
+    REQUIRE(it->Valid());
+    CHECK(it->key().ToString() == Key(2499));
+    it->Next();
+    REQUIRE(it->Valid());
+    CHECK(it->key().ToString() == Key(2500));
+    CHECK(detail::Read<int>(std::string_view(it->value().data(), it->value().size())) == 2500);
+}
+
+TEST_CASE("Memory backend takes concurrent writers") {
+    MemoryKeyValueDatabase db{};
+    REQUIRE(db.Open("unused").ok());
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&db, t] {
+            for (int i = t; i < 400; i += 4) {
+                CHECK(db.Put(Key(i), i).ok());
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    size_t count = 0;
+    for (const auto& entry : db.ScanPrefix<int>("item:")) {
+        CHECK(entry.key() == Key(static_cast<int>(count)));
+        ++count;
+    }
+    CHECK(count == 400);
+
+    std::string usage;
+    CHECK(db.backend().GetProperty("leveldb.approximate-memory-usage", &usage));
+    CHECK(usage != "0");
+}
+
+TEST_CASE("Sharded memory backend") {
+    TempDbFile file{};
+    BasicShardedKeyValueDatabase<JsonCodec, MemoryBackend> db{};
+    REQUIRE(db.Open(file.ToString(), 4).ok());
+    CHECK_FALSE(std::filesystem::exists(file.file));
+
+    for (int i = 0; i < 20; ++i) {
+        REQUIRE(db.Put(Key(i), i).ok());
+    }
+    int val = 0;
+    REQUIRE(db.Get(Key(7), val).ok());
+    CHECK(val == 7);
+
+    // Nothing is stored, so a different shard count is fine.
+    REQUIRE(db.Open(file.ToString(), 2).ok());
+    CHECK(db.Get(Key(7), val).IsNotFound());
+}
@@ -0,0 +1,100 @@
+#include "doctest.hpp"
+
+#include <oryx/key_value_database.hpp>
+#include <oryx/sharded_key_value_database.hpp>
+
+#include "test_utils.hpp"
+
+using namespace oryx;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct Dummy {
+    std::string prop0;
+    int prop1;
+};
+
+}  // namespace
+
+TEST_CASE("Latency histogram buckets") {
+    for (uint64_t nanos : {0ULL, 1ULL, 7ULL, 8ULL, 9ULL, 15ULL, 16ULL, 1000ULL, 123456789ULL}) {
+        const size_t bucket = LatencyHistogram::BucketFor(nanos);
+        CHECK(LatencyHistogram::LowerBound(bucket) <= nanos);
+        CHECK(nanos < LatencyHistogram::LowerBound(bucket + 1));
+        // Within one eighth of the value.
+        CHECK(nanos - LatencyHistogram::LowerBound(bucket) <= nanos / LatencyHistogram::kSubBuckets);
+    }
+    CHECK(LatencyHistogram::BucketFor(~0ULL) == LatencyHistogram::kBucketCount - 1);
+
+    LatencyHistogram histogram{};
+    CHECK(histogram.Percentile(0.5) == 0ns);
+    for (uint64_t i = 1; i <= 100; ++i) {
+        histogram.Record(i * 1000);
+    }
+    CHECK(histogram.count() == 100);
+    CHECK(histogram.Mean() == 50500ns);
+    const uint64_t smallest = LatencyHistogram::LowerBound(LatencyHistogram::BucketFor(1000));
+    CHECK(histogram.Percentile(0.0) == std::chrono::nanoseconds(smallest));
+    CHECK(histogram.Percentile(0.5) <= 50000ns);
+    CHECK(histogram.Percentile(0.5) > 50000ns * 7 / 8);
+    CHECK(histogram.Percentile(1.0) <= 100000ns);
+
+    LatencyHistogram other{};
+    other.Record(5);
+    histogram.Merge(other);
+    CHECK(histogram.count() == 101);
+    CHECK(histogram.Percentile(0.0) == 5ns);
+}
+
+TEST_CASE("Database metrics") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    REQUIRE(db.Put("myKey", Dummy{"a", 1}).ok());
+    REQUIRE(db.Put("bad", std::string("not json")).ok());
+    Dummy val{};
+    REQUIRE(db.Get("myKey", val).ok());
+    CHECK(db.Get("missing", val).IsNotFound());
+    CHECK_FALSE(db.Get("bad", val).ok());
+    REQUIRE(db.Delete("myKey").ok());
+
+    const DatabaseMetrics metrics = db.Metrics();
+    if constexpr (!detail::kMetricsEnabled) {
+        CHECK(metrics.get.count == 0);
+        CHECK(metrics.put.count == 0);
+        return;
+    }
+
+    CHECK(metrics.put.count == 2);
+    CHECK(metrics.put.engine.count() == 2);
+    CHECK(metrics.put.codec.count() == 2);
+    CHECK(metrics.put.bytes > 0);
+
+    CHECK(metrics.get.count == 3);
+    CHECK(metrics.get.engine.count() == 3);
+    // The missing key was never decoded.
+    CHECK(metrics.get.codec.count() == 2);
+    CHECK(metrics.parse_failures == 1);
+
+    CHECK(metrics.del.count == 1);
+    CHECK(metrics.del.codec.count() == 0);
+    CHECK(metrics.del.bytes == 5);
+
+    db.EnableObjectCache();
+    REQUIRE(db.Put("myKey", Dummy{"a", 1}).ok());
+    REQUIRE(db.Get("myKey", val).ok());
+    REQUIRE(db.Get("myKey", val).ok());
+    CHECK(db.Metrics().cache_hits == 1);
+}
+
+TEST_CASE("Sharded metrics add up") {
+    TempDbFile file{};
+    ShardedKeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString(), 3).ok());
+    for (int i = 0; i < 30; ++i) {
+        REQUIRE(db.Put("key" + std::to_string(i), i).ok());
+    }
+    CHECK(db.Metrics().put.count == (detail::kMetricsEnabled ? 30 : 0));
+}
@@ -0,0 +1,95 @@
+#include "doctest.hpp"
+
+#include <oryx/key_value_database.hpp>
+
+#include "test_utils.hpp"
+
+using namespace oryx;
+
+namespace {
+
+struct Dummy {
+    std::string prop0;
+    int prop1;
+};
+
+}  // namespace
+
+TEST_CASE("MultiGet returns results in key order") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    REQUIRE(db.Put("b", Dummy{"b", 2}).ok());
+    REQUIRE(db.Put("d", Dummy{"d", 4}).ok());
+    REQUIRE(db.Put("a", Dummy{"a", 1}).ok());
+    REQUIRE(db.Put("corrupt", std::string("{")).ok());
+
+    const std::vector<leveldb::Slice> keys{"d", "c", "a", "corrupt", "b", "d", "z"};
+    auto results = db.MultiGet<Dummy>(keys);
+    REQUIRE(results.size() == keys.size());
+
+    CHECK(results[0].status.ok());
+    CHECK(results[0].value.prop1 == 4);
+    CHECK(results[1].status.IsNotFound());
+    CHECK(results[2].status.ok());
+    CHECK(results[2].value.prop1 == 1);
+    CHECK(results[3].status.IsIOError());
+    CHECK(results[4].status.ok());
+    CHECK(results[4].value.prop0 == "b");
+    CHECK(results[5].status.ok());
+    CHECK(results[5].value.prop1 == 4);
+    CHECK(results[6].status.IsNotFound());
+}
+
+TEST_CASE("MultiGet with empty keys") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    CHECK(db.MultiGet<int>({}).empty());
+}
+
+TEST_CASE("MultiGet split over the async workers") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    db.EnableAsync({.threads = 2});
+
+    KeyValueDatabase::write_batch_type batch{};
+    std::vector<std::string> names;
+    for (int i = 0; i < 1000; ++i) {
+        names.push_back("key" + std::to_string(i));
+        if (i % 3 != 0) {
+            batch.Put(names.back(), i);
+        }
+    }
+    REQUIRE(db.Write(batch).ok());
+
+    std::vector<leveldb::Slice> keys(names.begin(), names.end());
+    auto results = db.MultiGet<int>(keys, KeyValueDatabase::DefaultReadOptions(), 4);
+    for (int i = 0; i < 1000; ++i) {
+        if (i % 3 == 0) {
+            CHECK(results[i].status.IsNotFound());
+        } else {
+            REQUIRE(results[i].status.ok());
+            CHECK(results[i].value == i);
+        }
+    }
+}
+
+TEST_CASE("MultiGet uses the object cache") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    db.EnableObjectCache();
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    REQUIRE(db.Put("a", 1).ok());
+    REQUIRE(db.Put("b", 2).ok());
+    const std::vector<leveldb::Slice> keys{"a", "b"};
+    REQUIRE(db.MultiGet<int>(keys)[0].status.ok());
+
+    REQUIRE(db.handle().Put(KeyValueDatabase::DefaultWriteOptions(), "a", "10").ok());
+    auto results = db.MultiGet<int>(keys);
+    CHECK(results[0].value == 1);
+    CHECK(results[1].value == 2);
+}
@@ -0,0 +1,154 @@
+#include "doctest.hpp"
+
+#include <oryx/key_value_database.hpp>
+#include <oryx/sharded_key_value_database.hpp>
+
+#include "test_utils.hpp"
+
+using namespace oryx;
+
+namespace {
+
+struct Dummy {
+    std::string prop0;
+    int prop1;
+};
+
+// Writes around KeyValueDatabase so the negative cache does not see the change.
+void RawPut(KeyValueDatabase& db, const std::string& key, const std::string& value) {
+    REQUIRE(db.handle().Put(KeyValueDatabase::DefaultWriteOptions(), key, value).ok());
+}
+
+}  // namespace
+
+TEST_CASE("Default options use a bloom filter") {
+    const auto opts = KeyValueDatabase::DefaultOptions();
+    REQUIRE(opts.filter_policy != nullptr);
+    CHECK(std::string(opts.filter_policy->Name()) == "leveldb.BuiltinBloomFilter2");
+    CHECK(KeyValueDatabase::DefaultOptions(KeyValueDatabase::kDefaultBloomBitsPerKey).filter_policy ==
+          opts.filter_policy);
+    CHECK(KeyValueDatabase::DefaultOptions(16).filter_policy != nullptr);
+    CHECK(KeyValueDatabase::DefaultOptions(0).filter_policy == nullptr);
+}
+
+TEST_CASE("Negative cache evicts the least recently missed keys") {
+    NegativeCache cache({.shard_count = 1, .max_keys = 2});
+    cache.Insert("a", cache.Generation("a"));
+    cache.Insert("b", cache.Generation("b"));
+    CHECK(cache.Contains("a"));
+    cache.Insert("c", cache.Generation("c"));
+    CHECK(cache.size() == 2);
+    CHECK(cache.Contains("a"));
+    CHECK_FALSE(cache.Contains("b"));
+    CHECK(cache.Contains("c"));
+
+    // A miss read before a write must not hide the written key.
+    const uint64_t generation = cache.Generation("d");
+    cache.Erase("d");
+    cache.Insert("d", generation);
+    CHECK_FALSE(cache.Contains("d"));
+
+    cache.Erase("a");
+    CHECK_FALSE(cache.Contains("a"));
+    cache.Clear();
+    CHECK(cache.size() == 0);
+}
+
+TEST_CASE("Contains") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    CHECK_FALSE(db.Contains("myKey"));
+    REQUIRE(db.Put("myKey", Dummy{"a", 1}).ok());
+    CHECK(db.Contains("myKey"));
+    REQUIRE(db.Delete("myKey").ok());
+    CHECK_FALSE(db.Contains("myKey"));
+
+    db.EnableWriteBehind({.interval = std::chrono::hours(1)});
+    REQUIRE(db.Put("myKey", Dummy{"b", 2}).ok());
+    CHECK(db.Contains("myKey"));
+}
+
+TEST_CASE("Negative cache answers repeated misses until the key is written") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    db.EnableNegativeCache();
+
+    Dummy val{};
+    CHECK(db.Get("missing", val).IsNotFound());
+    CHECK(db.negative_cache()->size() == 1);
+
+    // The write goes around the database, so the remembered miss still answers.
+    RawPut(db, "missing", R"({"prop0":"a","prop1":1})");
+    CHECK(db.Get("missing", val).IsNotFound());
+    CHECK_FALSE(db.Contains("missing"));
+    int prop1 = 0;
+    CHECK(db.GetField<&Dummy::prop1>("missing", prop1).IsNotFound());
+    CHECK(db.Get("missing", [](std::string_view) { FAIL("Read a remembered miss"); }).IsNotFound());
+    CHECK(db.MultiGet<Dummy>(std::vector<leveldb::Slice>{"missing"})[0].status.IsNotFound());
+
+    SUBCASE("Put") {
+        REQUIRE(db.Put("missing", Dummy{"b", 2}).ok());
+        REQUIRE(db.Get("missing", val).ok());
+        CHECK(val.prop1 == 2);
+    }
+
+    SUBCASE("Write") {
+        WriteBatch batch{};
+        batch.Put("missing", Dummy{"c", 3});
+        REQUIRE(db.Write(batch).ok());
+        CHECK(db.Contains("missing"));
+    }
+
+    SUBCASE("Update") {
+        // Starts from T{} as the key is remembered missing.
+        REQUIRE(db.Update<Dummy>("missing", [](Dummy& dummy) { dummy.prop1 += 10; }).ok());
+        REQUIRE(db.Get("missing", val).ok());
+        CHECK(val.prop1 == 10);
+    }
+
+    SUBCASE("Reopen") {
+        db.Close();
+        REQUIRE(db.Open(file.ToString()).ok());
+        CHECK(db.negative_cache()->size() == 0);
+        CHECK(db.Contains("missing"));
+    }
+}
+
+TEST_CASE("MultiGet remembers misses") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    db.EnableNegativeCache();
+    REQUIRE(db.Put("present", Dummy{"a", 1}).ok());
+
+    const std::vector<leveldb::Slice> keys{"missing1", "present", "missing2"};
+    auto results = db.MultiGet<Dummy>(keys);
+    CHECK(results[0].status.IsNotFound());
+    CHECK(results[1].status.ok());
+    CHECK(results[2].status.IsNotFound());
+    CHECK(db.negative_cache()->size() == 2);
+
+    // Answered from the negative cache although the write went around the database.
+    RawPut(db, "missing1", R"({"prop0":"b","prop1":2})");
+    CHECK(db.MultiGet<Dummy>(keys)[0].status.IsNotFound());
+    CHECK_FALSE(db.Contains("missing1"));
+
+    REQUIRE(db.Put("missing2", Dummy{"c", 3}).ok());
+    results = db.MultiGet<Dummy>(keys);
+    REQUIRE(results[2].status.ok());
+    CHECK(results[2].value.prop1 == 3);
+}
+
+TEST_CASE("Sharded negative cache") {
+    TempDbFile file{};
+    ShardedKeyValueDatabase db{};
+    db.EnableNegativeCache();
+    REQUIRE(db.Open(file.ToString(), 2).ok());
+
+    CHECK_FALSE(db.Contains("myKey"));
+    REQUIRE(db.Put("myKey", 1).ok());
+    CHECK(db.Contains("myKey"));
+}
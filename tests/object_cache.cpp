@@ -0,0 +1,112 @@
+#include "doctest.hpp"
+
+#include <oryx/key_value_database.hpp>
+
+#include "test_utils.hpp"
+
+using namespace oryx;
+
+namespace {
+
+struct Dummy {
+    std::string prop0;
+    int prop1;
+};
+
+// Writes around KeyValueDatabase so the cache does not see the change.
+void RawPut(KeyValueDatabase& db, const std::string& key, const std::string& value) {
+    REQUIRE(db.handle().Put(KeyValueDatabase::DefaultWriteOptions(), key, value).ok());
+}
+
+}  // namespace
+
+TEST_CASE("Object cache lookup and erase") {
+    ObjectCache cache{};
+    CHECK(cache.Lookup<int>("a") == nullptr);
+
+    cache.Insert("a", std::make_shared<const int>(1), sizeof(int), cache.Generation("a"));
+    cache.Insert("a", std::make_shared<const std::string>("one"), 3, cache.Generation("a"));
+    REQUIRE(cache.Lookup<int>("a") != nullptr);
+    CHECK(*cache.Lookup<int>("a") == 1);
+    CHECK(*cache.Lookup<std::string>("a") == "one");
+    CHECK(cache.size() == 2);
+
+    cache.Erase("a");
+    CHECK(cache.Lookup<int>("a") == nullptr);
+    CHECK(cache.Lookup<std::string>("a") == nullptr);
+    CHECK(cache.size() == 0);
+    CHECK(cache.charge() == 0);
+}
+
+TEST_CASE("Object cache skips inserts after erase") {
+    ObjectCache cache{};
+    const auto generation = cache.Generation("a");
+    cache.Erase("a");
+    cache.Insert("a", std::make_shared<const int>(1), sizeof(int), generation);
+    CHECK(cache.Lookup<int>("a") == nullptr);
+}
+
+TEST_CASE("Object cache evicts least recently used") {
+    ObjectCache cache{{.shard_count = 1, .max_entries = 2}};
+    cache.Insert("a", std::make_shared<const int>(1), 1, cache.Generation("a"));
+    cache.Insert("b", std::make_shared<const int>(2), 1, cache.Generation("b"));
+    CHECK(cache.Lookup<int>("a") != nullptr);
+    cache.Insert("c", std::make_shared<const int>(3), 1, cache.Generation("c"));
+
+    CHECK(cache.size() == 2);
+    CHECK(cache.Lookup<int>("a") != nullptr);
+    CHECK(cache.Lookup<int>("b") == nullptr);
+    CHECK(cache.Lookup<int>("c") != nullptr);
+
+    ObjectCache small{{.shard_count = 1, .capacity_bytes = 10}};
+    small.Insert("a", std::make_shared<const int>(1), 5, small.Generation("a"));
+    small.Insert("b", std::make_shared<const int>(2), 5, small.Generation("b"));
+    CHECK(small.size() == 1);
+    CHECK(small.charge() <= 10);
+}
+
+TEST_CASE("Cached reads skip the engine") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    db.EnableObjectCache();
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    REQUIRE(db.Put("myKey", Dummy{"hello", 5}).ok());
+    Dummy val{};
+    REQUIRE(db.Get("myKey", val).ok());
+
+    RawPut(db, "myKey", R"({"prop0":"changed","prop1":6})");
+    REQUIRE(db.Get("myKey", val).ok());
+    CHECK(val.prop0 == "hello");
+
+    std::shared_ptr<const Dummy> first;
+    std::shared_ptr<const Dummy> second;
+    REQUIRE(db.GetShared("myKey", first).ok());
+    REQUIRE(db.GetShared("myKey", second).ok());
+    CHECK(first == second);
+}
+
+TEST_CASE("Writes invalidate the object cache") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    db.EnableObjectCache();
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    Dummy val{};
+    REQUIRE(db.Put("myKey", Dummy{"hello", 5}).ok());
+    REQUIRE(db.Get("myKey", val).ok());
+    REQUIRE(db.Put("myKey", Dummy{"world", 6}).ok());
+    REQUIRE(db.Get("myKey", val).ok());
+    CHECK(val.prop0 == "world");
+
+    REQUIRE(db.Delete("myKey").ok());
+    CHECK(db.Get("myKey", val).IsNotFound());
+
+    REQUIRE(db.Put("myKey", Dummy{"batch", 1}).ok());
+    REQUIRE(db.Get("myKey", val).ok());
+    KeyValueDatabase::write_batch_type batch{};
+    batch.Put("myKey", Dummy{"batched", 2});
+    REQUIRE(db.Write(batch).ok());
+    REQUIRE(db.Get("myKey", val).ok());
+    CHECK(val.prop0 == "batched");
+}
@@ -1,10 +1,9 @@
 #include "doctest.hpp"
 
-#include <filesystem>
-
 #include <oryx/key_value_database.hpp>
 
-namespace fs = std::filesystem;
+#include "test_utils.hpp"
+
 using namespace oryx;
 
 struct Dummy {
@@ -13,19 +12,6 @@ struct Dummy {
     bool prop2;
 };
 
-struct TempDbFile {
-    TempDbFile()
-        : file(fs::temp_directory_path()) {
-        file.append("tmp.db");
-    }
-
-    ~TempDbFile() { std::filesystem::remove_all(file); }
-
-    auto ToString() { return file.string(); }
-
-    fs::path file;
-};
-
 static constexpr char kDummyString[] = R"({"prop0":"hello","prop1":5,"prop2":false})";
 static constexpr char kCorruptDummyString[] = R"({"prop"hello","prop5":5,"prop6":false})";
 
@@ -65,14 +51,26 @@ TEST_CASE("Writing supported types") {
     CHECK_EQ(detail::Write<std::string_view>("hello world1232!*2`-."), "hello world1232!*2`-.");
     CHECK_EQ(detail::Write<bool>(false), "0");
     CHECK_EQ(detail::Write<bool>(true), "1");
-    CHECK_EQ(detail::Write<double>(1.256), "1.256000");  // std::to_string appends 0 at the end for some reason
-    CHECK_EQ(detail::Write<float>(1.256f), "1.256000");
+    CHECK_EQ(detail::Write<double>(1.256), "1.256");
+    CHECK_EQ(detail::Write<double>(-1.256), "-1.256");
+    CHECK_EQ(detail::Write<double>(1e-9), "1e-09");
+    CHECK_EQ(detail::Write<float>(1.256f), "1.256");
     CHECK_EQ(detail::Write<uint64_t>(5), "5");
     CHECK_EQ(detail::Write<int64_t>(5), "5");
     CHECK_EQ(detail::Write<int>(5), "5");
     CHECK_EQ(detail::Write<int>(-5), "-5");
 }
 
+TEST_CASE("Floating point values round trip exactly") {
+    for (double val : {1.256, -1.256, 0.1, 1e-9, 1e300, -0.0, 3.141592653589793, 2.2250738585072014e-308}) {
+        CHECK(detail::Read<double>(detail::Write(val)).value() == val);
+    }
+    for (float val : {1.256f, 0.1f, 1e-9f, 3.4028235e38f}) {
+        CHECK(detail::Read<float>(detail::Write(val)).value() == val);
+    }
+    CHECK(detail::Read<double>("1.256000").value() == 1.256);
+}
+
 TEST_CASE("New closed database") {
     KeyValueDatabase db{};
     CHECK_FALSE(db.IsOpen());
@@ -133,4 +131,55 @@ TEST_CASE("Persisted write and read on db") {
     REQUIRE(db.Open(file.ToString()).ok());
     REQUIRE(db.Get("myKey", myVal).ok());
     REQUIRE(myVal == 5);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Visiting stored bytes on db") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+
+    REQUIRE(db.Open(file.ToString()).ok());
+    REQUIRE(db.Put("myKey", Dummy("hello", 5, false)).ok());
+    REQUIRE(db.Put("myKey2", 7).ok());
+
+    std::string_view::size_type size = 0;
+    auto visitor = [&](std::string_view bytes) { size = bytes.size(); };
+    REQUIRE(db.Get("myKey", visitor).ok());
+    CHECK(size == std::string_view(kDummyString).size());
+
+    int myVal = 0;
+    REQUIRE(db.Get("myKey2", [&](std::string_view bytes) { myVal = detail::Read<int>(bytes).value(); }).ok());
+    CHECK(myVal == 7);
+    REQUIRE(db.Get("myKey2", myVal).ok());
+    CHECK(myVal == 7);
+}
+
+TEST_CASE("Visiting missing key on db") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    bool called = false;
+
+    REQUIRE(db.Open(file.ToString()).ok());
+    REQUIRE(db.Put("myKey2", 7).ok());
+    auto status = db.Get("myKey", [&](std::string_view) { called = true; });
+    CHECK(status.IsNotFound());
+    CHECK_FALSE(called);
+}
+
+TEST_CASE("Writing from inside a visitor on db") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+
+    REQUIRE(db.Open(file.ToString()).ok());
+    REQUIRE(db.Put("myKey", std::string("hello")).ok());
+
+    std::string copied;
+    REQUIRE(db.Get("myKey", [&](std::string_view bytes) {
+                  REQUIRE(db.Put("myKey2", 7).ok());
+                  copied = bytes;
+              }).ok());
+    CHECK_EQ(copied, "hello");
+
+    int myVal = 0;
+    REQUIRE(db.Get("myKey2", myVal).ok());
+    CHECK(myVal == 7);
+}
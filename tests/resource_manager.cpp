@@ -0,0 +1,99 @@
+#include "doctest.hpp"
+
+#include <oryx/key_value_database.hpp>
+#include <oryx/resource_manager.hpp>
+#include <oryx/sharded_key_value_database.hpp>
+
+#include "test_utils.hpp"
+
+using namespace oryx;
+
+namespace {
+
+constexpr size_t kMB = 1024 * 1024;
+
+}  // namespace
+
+TEST_CASE("Resource manager splits its budgets over the open databases") {
+    ResourceManager manager({.block_cache_bytes = kMB,
+                             .write_buffer_bytes = 8 * kMB,
+                             .write_buffer_bytes_per_database = 4 * kMB,
+                             .open_files = 300,
+                             .open_files_per_database = 200});
+
+    leveldb::Options first_opts{};
+    auto first = manager.Acquire(first_opts);
+    CHECK(first_opts.block_cache == manager.cache());
+    CHECK(first_opts.write_buffer_size == 4 * kMB);
+    CHECK(first_opts.max_open_files == 200);
+
+    leveldb::Options second_opts{};
+    auto second = manager.Acquire(second_opts);
+    CHECK(second_opts.block_cache == manager.cache());
+    CHECK(second_opts.write_buffer_size == 4 * kMB);
+    CHECK(second_opts.max_open_files == 100);
+
+    // The budget is used up, the third database gets leveldb's minimums.
+    leveldb::Options third_opts{};
+    auto third = manager.Acquire(third_opts);
+    CHECK(third_opts.write_buffer_size == ResourceManager::kMinWriteBufferBytes);
+    CHECK(third_opts.max_open_files == static_cast<int>(ResourceManager::kMinOpenFiles));
+    CHECK(manager.open_databases() == 3);
+
+    // A closed database returns its share to the next one.
+    first.reset();
+    CHECK(manager.open_databases() == 2);
+    CHECK(manager.write_buffer_bytes_in_use() == 4 * kMB + ResourceManager::kMinWriteBufferBytes);
+    leveldb::Options fourth_opts{};
+    auto fourth = manager.Acquire(fourth_opts);
+    CHECK(fourth_opts.write_buffer_size == 8 * kMB / 3);
+    CHECK(fourth_opts.max_open_files == 100);
+
+    second.reset();
+    third.reset();
+    fourth.reset();
+    CHECK(manager.open_databases() == 0);
+    CHECK(manager.write_buffer_bytes_in_use() == 0);
+    CHECK(manager.open_files_in_use() == 0);
+}
+
+TEST_CASE("Databases hold a share while they are open") {
+    ResourceManager manager{};
+    TempDbFile first_file{};
+    TempDbFile second_file{"second.db"};
+    KeyValueDatabase first{};
+    KeyValueDatabase second{};
+    first.EnableSharedResources(manager);
+    second.EnableSharedResources(manager);
+
+    REQUIRE(first.Open(first_file.ToString()).ok());
+    REQUIRE(second.Open(second_file.ToString()).ok());
+    CHECK(manager.open_databases() == 2);
+
+    REQUIRE(first.Put("myKey", 1).ok());
+    int myVal = 0;
+    REQUIRE(first.Get("myKey", myVal).ok());
+    CHECK(myVal == 1);
+
+    first.Close();
+    CHECK(manager.open_databases() == 1);
+
+    // Applies from the next Open on.
+    second.DisableSharedResources();
+    CHECK(manager.open_databases() == 1);
+    REQUIRE(second.Open(second_file.ToString()).ok());
+    CHECK(manager.open_databases() == 0);
+}
+
+TEST_CASE("Every shard holds its own share") {
+    ResourceManager manager{};
+    TempDbFile file{};
+    {
+        ShardedKeyValueDatabase db{};
+        db.EnableSharedResources(manager);
+        REQUIRE(db.Open(file.ToString(), 4).ok());
+        CHECK(manager.open_databases() == 4);
+        CHECK(manager.write_buffer_bytes_in_use() == 4 * manager.budget().write_buffer_bytes_per_database);
+    }
+    CHECK(manager.open_databases() == 0);
+}
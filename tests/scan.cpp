@@ -0,0 +1,105 @@
+#include "doctest.hpp"
+
+#include <oryx/key_value_database.hpp>
+
+#include "test_utils.hpp"
+
+using namespace oryx;
+
+namespace {
+
+struct Dummy {
+    std::string prop0;
+    int prop1;
+};
+
+void Fill(KeyValueDatabase& db) {
+    KeyValueDatabase::write_batch_type batch{};
+    batch.Put("item:a", Dummy{"a", 1});
+    batch.Put("item:b", Dummy{"b", 2});
+    batch.Put("item:c", Dummy{"c", 3});
+    batch.Put("items", Dummy{"s", 4});
+    batch.Put("other", Dummy{"o", 5});
+    REQUIRE(db.Write(batch).ok());
+}
+
+}  // namespace
+
+static_assert(std::ranges::input_range<ScanRange<Dummy>>);
+
+TEST_CASE("Scan stops at the upper bound") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    Fill(db);
+
+    std::vector<std::string> keys;
+    std::vector<int> values;
+    auto scan = db.Scan<Dummy>("item:b", "items");
+    for (const auto& entry : scan) {
+        keys.emplace_back(entry.key());
+        values.push_back(entry.value().value().prop1);
+    }
+    CHECK(scan.status().ok());
+    CHECK(keys == std::vector<std::string>{"item:b", "item:c"});
+    CHECK(values == std::vector<int>{2, 3});
+}
+
+TEST_CASE("Scan with empty end runs to the last key") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    Fill(db);
+
+    size_t count = 0;
+    for (const auto& entry : db.Scan<Dummy>("items", "", KeyValueDatabase::BulkReadOptions())) {
+        CHECK(entry.value().has_value());
+        ++count;
+    }
+    CHECK(count == 2);
+}
+
+TEST_CASE("Prefix scan only returns matching keys") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    Fill(db);
+    REQUIRE(db.Put("item:corrupt", std::string("{")).ok());
+
+    std::vector<std::string> keys;
+    size_t decoded = 0;
+    for (const auto& entry : db.ScanPrefix<Dummy>("item:")) {
+        keys.emplace_back(entry.key());
+        decoded += entry.value().has_value();
+    }
+    CHECK(keys == std::vector<std::string>{"item:a", "item:b", "item:c", "item:corrupt"});
+    CHECK(decoded == 3);
+
+    auto missing = db.ScanPrefix<Dummy>("nothing");
+    CHECK(missing.begin() == missing.end());
+}
+
+TEST_CASE("Scan works with range algorithms") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    Fill(db);
+
+    auto scan = db.ScanPrefix<Dummy>("item");
+    auto sum = 0;
+    std::ranges::for_each(scan, [&](const auto& entry) { sum += entry.value()->prop1; });
+    CHECK(sum == 10);
+}
+
+TEST_CASE("Scan that could not flush buffered writes is empty and reports the error") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    Fill(db);
+
+    ScanRange<Dummy> scan(std::unique_ptr<leveldb::Iterator>(db.handle().NewIterator(db.DefaultReadOptions())),
+                          leveldb::BytewiseComparator(), "item:", leveldb::Slice(), "item:", nullptr,
+                          leveldb::Status::IOError("flush failed"));
+    CHECK(scan.begin() == scan.end());
+    CHECK(scan.status().IsIOError());
+}
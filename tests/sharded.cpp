@@ -0,0 +1,87 @@
+#include "doctest.hpp"
+
+#include <oryx/sharded_key_value_database.hpp>
+
+#include "test_utils.hpp"
+
+using namespace oryx;
+
+namespace {
+
+struct Dummy {
+    std::string prop0;
+    int prop1;
+};
+
+}  // namespace
+
+TEST_CASE("Stable key hash") {
+    CHECK(detail::Fnv1a("") == 14695981039346656037ULL);
+    CHECK(detail::Fnv1a("a") == 0xaf63dc4c8601ec8cULL);
+    CHECK(detail::Fnv1a("foobar") == 0x85944171f73967e8ULL);
+}
+
+TEST_CASE("Sharded write and read") {
+    TempDbFile file{};
+    ShardedKeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString(), 4).ok());
+    REQUIRE(db.IsOpen());
+    REQUIRE(db.shard_count() == 4);
+
+    std::vector<size_t> per_shard(db.shard_count());
+    for (int i = 0; i < 100; ++i) {
+        const auto key = "key" + std::to_string(i);
+        REQUIRE(db.Put(key, Dummy{key, i}).ok());
+        ++per_shard[db.ShardIndex(key)];
+    }
+    for (auto count : per_shard) {
+        CHECK(count > 0);
+    }
+
+    Dummy val{};
+    REQUIRE(db.Get("key42", val).ok());
+    CHECK(val.prop0 == "key42");
+    CHECK(val.prop1 == 42);
+    int prop1 = 0;
+    REQUIRE(db.GetField<&Dummy::prop1>("key42", prop1).ok());
+    CHECK(prop1 == 42);
+
+    // Keys only live in the shard they hash to.
+    const auto index = db.ShardIndex("key42");
+    CHECK(db.shard((index + 1) % db.shard_count()).Get("key42", val).IsNotFound());
+
+    REQUIRE(db.Delete("key42").ok());
+    CHECK(db.Get("key42", val).IsNotFound());
+}
+
+TEST_CASE("Sharded database rejects operations while not open") {
+    ShardedKeyValueDatabase db{};
+    REQUIRE_FALSE(db.IsOpen());
+
+    Dummy val{};
+    int prop1 = 0;
+    CHECK(db.Put("key", Dummy{"key", 1}).IsInvalidArgument());
+    CHECK(db.Get("key", val).IsInvalidArgument());
+    CHECK(db.GetField<&Dummy::prop1>("key", prop1).IsInvalidArgument());
+    CHECK(db.Update<Dummy>("key", [](Dummy& dummy) { ++dummy.prop1; }).IsInvalidArgument());
+    CHECK(db.Delete("key").IsInvalidArgument());
+    CHECK_FALSE(db.Contains("key"));
+    CHECK(db.ShardIndex("key") == 0);
+}
+
+TEST_CASE("Sharded database persists and keeps its shard count") {
+    TempDbFile file{};
+    ShardedKeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString(), 3).ok());
+    REQUIRE(db.Put("myKey", 5).ok());
+    db.Close();
+    REQUIRE_FALSE(db.IsOpen());
+
+    CHECK(db.Open(file.ToString(), 5).IsInvalidArgument());
+    CHECK(db.Open(file.ToString(), 0).IsInvalidArgument());
+
+    REQUIRE(db.Open(file.ToString(), 3).ok());
+    int myVal = 0;
+    REQUIRE(db.Get("myKey", myVal).ok());
+    CHECK(myVal == 5);
+}
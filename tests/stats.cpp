@@ -0,0 +1,95 @@
+#include "doctest.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <oryx/key_value_database.hpp>
+#include <oryx/sharded_key_value_database.hpp>
+
+#include "test_utils.hpp"
+
+using namespace oryx;
+using namespace std::chrono_literals;
+
+TEST_CASE("Parse leveldb stats") {
+    EngineStats stats{};
+    REQUIRE(detail::ParseLevelStats("                               Compactions\n"
+                                    "Level  Files Size(MB) Time(sec) Read(MB) Write(MB)\n"
+                                    "--------------------------------------------------\n"
+                                    "  0        9        3         1        0         3\n"
+                                    "  2       14       25         2       30.5      26\n",
+                                    stats));
+    CHECK(stats.levels[0].files == 9);
+    CHECK(stats.levels[1].files == 0);
+    CHECK(stats.levels[2].compaction_read_mb == 30.5);
+    CHECK(stats.sstables() == 23);
+    CHECK(stats.compaction_written_mb() == 29);
+    CHECK(stats.writes_slowed());
+    CHECK_FALSE(stats.writes_stopped());
+
+    EngineStats empty{};
+    CHECK(detail::ParseLevelStats("Level  Files Size(MB) Time(sec) Read(MB) Write(MB)\n"
+                                  "--------------------------------------------------\n",
+                                  empty));
+    CHECK(empty.sstables() == 0);
+    CHECK_FALSE(detail::ParseLevelStats("garbage", empty));
+    CHECK_FALSE(detail::ParseLevelStats("---\n  9 1 1 1 1 1\n", empty));
+}
+
+TEST_CASE("Parse leveldb sstables") {
+    EngineStats stats{};
+    REQUIRE(detail::ParseTableSizes("--- level 0 ---\n"
+                                    " 7:1534['a' @ 3 : 1 .. 'c' @ 5 : 1]\n"
+                                    " 9:200['d' @ 6 : 1 .. 'e' @ 7 : 1]\n"
+                                    "--- level 1 ---\n"
+                                    "--- level 2 ---\n"
+                                    " 4:3000000['a' @ 1 : 1 .. 'z' @ 2 : 1]\n",
+                                    stats));
+    CHECK(stats.levels[0].size_bytes == 1734);
+    CHECK(stats.levels[1].size_bytes == 0);
+    CHECK(stats.levels[2].size_bytes == 3000000);
+    CHECK(stats.size_bytes() == 3001734);
+
+    CHECK_FALSE(detail::ParseTableSizes(" 7:1534['a' @ 3 : 1 .. 'c' @ 5 : 1]\n", stats));
+    CHECK_FALSE(detail::ParseTableSizes("--- level 9 ---\n", stats));
+}
+
+TEST_CASE("Database stats") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(db.Put("key" + std::to_string(i), std::string(1000, 'x')).ok());
+    }
+
+    EngineStats stats{};
+    REQUIRE(db.Stats(stats).ok());
+    CHECK(stats.approximate_memory_usage > 0);
+    CHECK_FALSE(stats.writes_stopped());
+
+    // The compacted tables are far below a megabyte, which leveldb.stats reports as 0.
+    db.handle().CompactRange(nullptr, nullptr);
+    REQUIRE(db.Stats(stats).ok());
+    CHECK(stats.sstables() >= 1);
+    CHECK(stats.size_bytes() > 0);
+    CHECK(stats.size_bytes() < 1024 * 1024);
+}
+
+TEST_CASE("Stats sampler") {
+    TempDbFile file{};
+    ShardedKeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString(), 2).ok());
+    REQUIRE(db.Put("myKey", 5).ok());
+
+    std::atomic<int> samples{0};
+    StatsSampler sampler(db, 5ms, [&](const EngineStats& stats) {
+        CHECK(stats.approximate_memory_usage > 0);
+        ++samples;
+    });
+    for (int i = 0; i < 500 && samples < 2; ++i) {
+        std::this_thread::sleep_for(10ms);
+    }
+    CHECK(samples >= 2);
+    CHECK(sampler.latest().has_value());
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+struct TempDbFile {
+    explicit TempDbFile(const std::string& name = "tmp.db")
+        : file(std::filesystem::temp_directory_path()) {
+        file.append(name);
+        // Left over if a previous run crashed.
+        std::filesystem::remove_all(file);
+    }
+
+    ~TempDbFile() { std::filesystem::remove_all(file); }
+
+    auto ToString() { return file.string(); }
+
+    std::filesystem::path file;
+};
@@ -0,0 +1,115 @@
+#include "doctest.hpp"
+
+#include <thread>
+#include <vector>
+
+#include <oryx/key_value_database.hpp>
+#include <oryx/sharded_key_value_database.hpp>
+
+#include "test_utils.hpp"
+
+using namespace oryx;
+
+namespace {
+
+struct Counter {
+    std::string name;
+    int64_t value;
+};
+
+void IncrementConcurrently(KeyValueDatabase& db, int threads, int increments) {
+    std::vector<std::thread> writers;
+    for (int t = 0; t < threads; ++t) {
+        writers.emplace_back([&db, increments, t] {
+            for (int i = 0; i < increments; ++i) {
+                const auto key = "counter" + std::to_string((t + i) % 4);
+                CHECK(db.Update<Counter>(key, [&](Counter& counter) {
+                            counter.name = key;
+                            ++counter.value;
+                        }).ok());
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+}
+
+auto Total(KeyValueDatabase& db) -> int64_t {
+    int64_t total = 0;
+    for (int i = 0; i < 4; ++i) {
+        Counter counter{};
+        REQUIRE(db.Get("counter" + std::to_string(i), counter).ok());
+        CHECK(counter.name == "counter" + std::to_string(i));
+        total += counter.value;
+    }
+    return total;
+}
+
+}  // namespace
+
+TEST_CASE("Update starts from a default object and can skip the write") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    REQUIRE(db.Update<Counter>("myKey", [](Counter& counter) { counter.value += 5; }).ok());
+    Counter counter{};
+    REQUIRE(db.Get("myKey", counter).ok());
+    CHECK(counter.value == 5);
+
+    REQUIRE(db.Update<Counter>("myKey", [](Counter& counter) { return ++counter.value < 5; }).ok());
+    REQUIRE(db.Get("myKey", counter).ok());
+    CHECK(counter.value == 5);
+
+    REQUIRE(db.Update<Counter>("other", [](Counter&) { return false; }).ok());
+    CHECK(db.Get("other", counter).IsNotFound());
+}
+
+TEST_CASE("Concurrent updates of the same keys are not lost") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    SUBCASE("Plain") {}
+    SUBCASE("Object cache") { db.EnableObjectCache(); }
+    SUBCASE("Object cache and async") {
+        db.EnableObjectCache();
+        db.EnableAsync({.threads = 2});
+    }
+    SUBCASE("Write behind") { db.EnableWriteBehind({.max_buffered_bytes = 256}); }
+
+    IncrementConcurrently(db, 8, 200);
+    CHECK(Total(db) == 8 * 200);
+}
+
+TEST_CASE("Update caches the updated object") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    db.EnableObjectCache();
+
+    REQUIRE(db.Update<Counter>("myKey", [](Counter& counter) { counter.value = 7; }).ok());
+    auto cached = db.object_cache()->Lookup<Counter>("myKey");
+    REQUIRE(cached);
+    CHECK(cached->value == 7);
+
+    // A plain write afterwards still wins.
+    REQUIRE(db.Put("myKey", Counter{"", 8}).ok());
+    Counter counter{};
+    REQUIRE(db.Get("myKey", counter).ok());
+    CHECK(counter.value == 8);
+}
+
+TEST_CASE("Sharded update") {
+    TempDbFile file{};
+    ShardedKeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString(), 2).ok());
+
+    for (int i = 0; i < 3; ++i) {
+        REQUIRE(db.Update<Counter>("myKey", [](Counter& counter) { ++counter.value; }).ok());
+    }
+    Counter counter{};
+    REQUIRE(db.Get("myKey", counter).ok());
+    CHECK(counter.value == 3);
+}
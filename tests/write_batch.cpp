@@ -0,0 +1,59 @@
+#include "doctest.hpp"
+
+#include <oryx/key_value_database.hpp>
+
+#include "test_utils.hpp"
+
+using namespace oryx;
+
+namespace {
+
+struct Item {
+    std::string name;
+    int count;
+};
+
+}  // namespace
+
+TEST_CASE("Write batch size grows with updates") {
+    WriteBatch batch{};
+    const auto empty_size = batch.ApproximateSize();
+
+    batch.Put("a", Item{"apple", 1});
+    const auto put_size = batch.ApproximateSize();
+    CHECK(put_size > empty_size);
+
+    batch.Delete("b");
+    CHECK(batch.ApproximateSize() > put_size);
+
+    batch.Clear();
+    CHECK(batch.ApproximateSize() == empty_size);
+}
+
+TEST_CASE("Write batch is applied on db") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    REQUIRE(db.Put("stale", 1).ok());
+
+    KeyValueDatabase::write_batch_type batch{};
+    batch.Put("a", Item{"apple", 1});
+    batch.Put("b", std::string("banana"));
+    batch.Put("c", 3);
+    batch.Delete("stale");
+    REQUIRE(db.Write(batch).ok());
+
+    Item item{};
+    REQUIRE(db.Get("a", item).ok());
+    CHECK(item.name == "apple");
+    CHECK(item.count == 1);
+
+    std::string str;
+    REQUIRE(db.Get("b", str).ok());
+    CHECK(str == "banana");
+
+    int number = 0;
+    REQUIRE(db.Get("c", number).ok());
+    CHECK(number == 3);
+    CHECK(db.Get("stale", number).IsNotFound());
+}
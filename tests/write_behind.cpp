@@ -0,0 +1,162 @@
+#include "doctest.hpp"
+
+#include <chrono>
+#include <thread>
+
+#include <oryx/key_value_database.hpp>
+#include <oryx/sharded_key_value_database.hpp>
+
+#include "test_utils.hpp"
+
+using namespace oryx;
+using namespace std::chrono_literals;
+
+namespace {
+
+struct Dummy {
+    std::string prop0;
+    int prop1;
+};
+
+// Reads around the buffer.
+auto InEngine(KeyValueDatabase& db, const std::string& key) -> bool {
+    std::string value;
+    return db.handle().Get(leveldb::ReadOptions{}, key, &value).ok();
+}
+
+}  // namespace
+
+TEST_CASE("Write behind serves reads from the buffer and writes the latest value") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    db.EnableObjectCache();
+    db.EnableWriteBehind({.interval = 1h});
+
+    for (int i = 0; i < 100; ++i) {
+        REQUIRE(db.Put("counter", Dummy{"a", i}).ok());
+    }
+    CHECK_FALSE(InEngine(db, "counter"));
+
+    Dummy val{};
+    REQUIRE(db.Get("counter", val).ok());
+    CHECK(val.prop1 == 99);
+    std::shared_ptr<const Dummy> shared;
+    REQUIRE(db.GetShared("counter", shared).ok());
+    CHECK(shared->prop1 == 99);
+    int prop1 = 0;
+    REQUIRE(db.GetField<&Dummy::prop1>("counter", prop1).ok());
+    CHECK(prop1 == 99);
+    CHECK(db.Get("counter", [](std::string_view bytes) { CHECK_FALSE(bytes.empty()); }).ok());
+
+    const std::vector<leveldb::Slice> keys{"counter", "missing"};
+    auto results = db.MultiGet<Dummy>(keys);
+    CHECK(results[0].value.prop1 == 99);
+    CHECK(results[1].status.IsNotFound());
+
+    REQUIRE(db.Flush().ok());
+    CHECK(InEngine(db, "counter"));
+
+    // A buffered delete hides the flushed value.
+    REQUIRE(db.Delete("counter").ok());
+    CHECK(InEngine(db, "counter"));
+    CHECK(db.Get("counter", val).IsNotFound());
+    CHECK(db.MultiGet<Dummy>(keys)[0].status.IsNotFound());
+    REQUIRE(db.Flush().ok());
+    CHECK_FALSE(InEngine(db, "counter"));
+}
+
+TEST_CASE("Write behind buffers write batches") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    REQUIRE(db.Put("key1", 1).ok());
+    db.EnableWriteBehind({.interval = 1h});
+
+    WriteBatch batch{};
+    batch.Put("key1", 2);
+    batch.Put("key2", 3);
+    REQUIRE(db.Write(batch).ok());
+    CHECK_FALSE(InEngine(db, "key2"));
+
+    int myVal = 0;
+    REQUIRE(db.Get("key2", myVal).ok());
+    CHECK(myVal == 3);
+
+    REQUIRE(db.Get("key1", myVal).ok());
+    CHECK(myVal == 2);
+}
+
+TEST_CASE("Write behind flushes on size, interval, scans and close") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+
+    SUBCASE("Size") {
+        db.EnableWriteBehind({.interval = 1h, .max_buffered_bytes = 64});
+        REQUIRE(db.Put("small", 1).ok());
+        CHECK_FALSE(InEngine(db, "small"));
+        REQUIRE(db.Put("large", std::string(128, 'x')).ok());
+        CHECK(InEngine(db, "small"));
+        CHECK(InEngine(db, "large"));
+    }
+
+    SUBCASE("Interval") {
+        db.EnableWriteBehind({.interval = 5ms});
+        REQUIRE(db.Put("myKey", 1).ok());
+        for (int i = 0; i < 500 && !InEngine(db, "myKey"); ++i) {
+            std::this_thread::sleep_for(10ms);
+        }
+        CHECK(InEngine(db, "myKey"));
+    }
+
+    SUBCASE("Scan") {
+        db.EnableWriteBehind({.interval = 1h});
+        REQUIRE(db.Put("user:1", 1).ok());
+        REQUIRE(db.Put("user:2", 2).ok());
+        int count = 0;
+        for (const auto& entry : db.ScanPrefix<int>("user:")) {
+            CHECK(entry.value() == ++count);
+        }
+        CHECK(count == 2);
+    }
+
+    SUBCASE("Close") {
+        db.EnableWriteBehind({.interval = 1h});
+        REQUIRE(db.Put("myKey", 1).ok());
+        db.Close();
+        REQUIRE(db.Open(file.ToString()).ok());
+        CHECK(InEngine(db, "myKey"));
+        REQUIRE(db.DisableWriteBehind().ok());
+    }
+}
+
+TEST_CASE("Write behind takes async writes") {
+    TempDbFile file{};
+    KeyValueDatabase db{};
+    REQUIRE(db.Open(file.ToString()).ok());
+    db.EnableWriteBehind({.interval = 1h});
+    db.EnableAsync();
+
+    REQUIRE(db.PutAsync("myKey", 5).get().ok());
+    CHECK_FALSE(InEngine(db, "myKey"));
+    auto read = db.GetAsync<int>("myKey").get();
+    REQUIRE(read.status.ok());
+    CHECK(read.value == 5);
+
+    REQUIRE(db.DeleteAsync("myKey").get().ok());
+    CHECK(db.GetAsync<int>("myKey").get().status.IsNotFound());
+}
+
+TEST_CASE("Sharded write behind") {
+    TempDbFile file{};
+    ShardedKeyValueDatabase db{};
+    db.EnableWriteBehind({.interval = 1h});
+    REQUIRE(db.Open(file.ToString(), 2).ok());
+
+    REQUIRE(db.Put("myKey", 5).ok());
+    auto& shard = db.shard(db.ShardIndex("myKey"));
+    CHECK_FALSE(InEngine(shard, "myKey"));
+    REQUIRE(db.Flush().ok());
+    CHECK(InEngine(shard, "myKey"));
+}
@@ -0,0 +1,43 @@
+// Trains a new version of a value compression dictionary from the values stored under a key prefix:
+// kvdb-cpp_train_dictionary <database> <dictionary name> <key prefix> [max dictionary bytes] [max samples]
+// Running processes pick the new version up the next time they open the database.
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+#include <oryx/key_value_database.hpp>
+
+auto main(int argc, char** argv) -> int {
+    if (argc < 4 || argc > 6) {
+        std::fprintf(stderr,
+                     "usage: %s <database> <dictionary name> <key prefix> [max dictionary bytes] [max samples]\n",
+                     argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    oryx::DictionaryOptions opts{};
+    if (argc > 4) {
+        opts.max_dictionary_bytes = std::stoull(argv[4]);
+    }
+    if (argc > 5) {
+        opts.max_samples = std::stoull(argv[5]);
+    }
+
+    auto db_opts = oryx::KeyValueDatabase::DefaultOptions();
+    db_opts.create_if_missing = false;
+
+    oryx::KeyValueDatabase db{};
+    if (auto status = db.Open(argv[1], db_opts); !status.ok()) {
+        std::fprintf(stderr, "%s\n", status.ToString().c_str());
+        return EXIT_FAILURE;
+    }
+
+    if (auto status = db.TrainDictionary(argv[2], argv[3], opts); !status.ok()) {
+        std::fprintf(stderr, "%s\n", status.ToString().c_str());
+        return EXIT_FAILURE;
+    }
+
+    std::printf("Trained a new version of dictionary %s\n", argv[2]);
+    return EXIT_SUCCESS;
+}